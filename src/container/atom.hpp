@@ -12,6 +12,7 @@
 #pragma once
 
 #include "definitions.hpp"
+#include "enhance/symbol.hpp"
 
 #include <iostream>
 #include <iomanip>
@@ -24,7 +25,7 @@
 struct Atom
 {
     std::size_t id          {0};
-    std::string name        {};
+    enhance::Symbol name    {};
     REALVEC     position    {0, 0, 0};
     REALVEC     velocity    {0, 0, 0};
 
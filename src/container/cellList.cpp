@@ -0,0 +1,90 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "container/cellList.hpp"
+
+//
+// (re)build cell list from positions
+// (positions outside of the box are wrapped back according to periodic boundaries)
+//
+void CellList::build(const std::vector<REALVEC>& positions, const REALVEC& box, const REAL& cellSize)
+{
+    dimensions = box;
+    for( std::size_t i=0; i<3; ++i )
+    {
+        if( dimensions[i] > 0 && cellSize > 0 )
+            nCells[i] = std::max( static_cast<std::size_t>(1), static_cast<std::size_t>( std::floor(dimensions[i] / cellSize) ) );
+        else
+            nCells[i] = 1;
+    }
+    rsmdDEBUG( "building cell list with " << nCells[0] << "x" << nCells[1] << "x" << nCells[2] << " cells for " << positions.size() << " entries" );
+
+    // counting sort of entries according to cells
+    std::vector<std::size_t> cells( positions.size() );
+    cellStart.assign( nCells[0] * nCells[1] * nCells[2] + 1, 0 );
+    for( std::size_t i=0; i<positions.size(); ++i )
+    {
+        auto c = cellCoordinates(positions[i]);
+        cells[i] = cellIndex(c[0], c[1], c[2]);
+        ++ cellStart[cells[i] + 1];
+    }
+    for( std::size_t c=1; c<cellStart.size(); ++c )
+    {
+        cellStart[c] += cellStart[c-1];
+    }
+    entries.resize( positions.size() );
+    std::vector<std::size_t> fill( cellStart.begin(), cellStart.end() - 1 );
+    for( std::size_t i=0; i<positions.size(); ++i )
+    {
+        entries[ fill[cells[i]] ++ ] = i;
+    }
+}
+
+
+//
+// cell coordinates of a position
+//
+std::array<std::size_t, 3> CellList::cellCoordinates(const REALVEC& position) const
+{
+    std::array<std::size_t, 3> coordinates {0, 0, 0};
+    for( std::size_t i=0; i<3; ++i )
+    {
+        if( nCells[i] == 1 ) continue;
+        REAL scaled = position[i] / dimensions[i];
+        scaled -= std::floor(scaled);
+        auto c = static_cast<std::size_t>( scaled * nCells[i] );
+        coordinates[i] = std::min( c, nCells[i] - 1 );
+    }
+    return coordinates;
+}
+
+
+//
+// coordinates of neighbouring cells in one dimension
+//
+std::size_t CellList::neighbourCells(std::size_t centre, std::size_t n, std::array<std::size_t, 3>& neighbours) const
+{
+    if( n == 1 )
+    {
+        neighbours[0] = 0;
+        return 1;
+    }
+    else if( n == 2 )
+    {
+        neighbours[0] = 0;
+        neighbours[1] = 1;
+        return 2;
+    }
+    neighbours[0] = (centre + n - 1) % n;
+    neighbours[1] = centre;
+    neighbours[2] = (centre + 1) % n;
+    return 3;
+}
@@ -0,0 +1,130 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "definitions.hpp"
+
+#include <vector>
+#include <array>
+#include <cmath>
+#include <algorithm>
+
+//
+// cell list container
+//
+// a periodic linked-cell index over a set of positions:
+// the box is divided into cells that are at least cellSize wide in each dimension,
+// such that all positions within cellSize of a given point are found
+// in the cell containing that point or one of its (up to 26) neighbouring cells
+//
+// entries are stored as the indices of the positions given to build()
+//
+
+class CellList
+{
+    REALVEC dimensions {0, 0, 0};
+    std::array<std::size_t, 3> nCells {1, 1, 1};
+    std::vector<std::size_t> cellStart {};  // first entry of each cell (+ one past the last entry)
+    std::vector<std::size_t> entries {};    // entry indices, sorted according to cells
+
+    //
+    // cell coordinates / cell index of a position
+    //
+    std::array<std::size_t, 3> cellCoordinates(const REALVEC&) const;
+    inline std::size_t cellIndex(std::size_t x, std::size_t y, std::size_t z) const
+    {
+        return (x * nCells[1] + y) * nCells[2] + z;
+    }
+
+    //
+    // coordinates of neighbouring cells in one dimension
+    // (without duplicates if there are less than three cells)
+    //
+    std::size_t neighbourCells(std::size_t, std::size_t, std::array<std::size_t, 3>&) const;
+
+  public:
+    //
+    // (re)build cell list from positions
+    //
+    void build(const std::vector<REALVEC>&, const REALVEC&, const REAL&);
+
+    //
+    // call function for all entries in the cell of the given position
+    // and in its neighbouring cells
+    //
+    template<typename F>
+    void forEachNeighbour(const REALVEC&, F&&) const;
+
+    //
+    // call function for the cell of the given position and for its neighbouring cells,
+    // with the range [first, last) of the cell in getEntries()
+    //
+    template<typename F>
+    void forEachNeighbourCell(const REALVEC&, F&&) const;
+
+    //
+    // some getters
+    //
+    inline auto        size()       const { return entries.size(); }
+    inline const auto& getNCells()  const { return nCells; }
+    inline const auto& getEntries() const { return entries; }
+
+    //
+    // clear cell list
+    //
+    inline void clear()
+    {
+        dimensions.setZero();
+        nCells = {1, 1, 1};
+        cellStart.clear();
+        entries.clear();
+    }
+};
+
+
+
+template<typename F>
+void CellList::forEachNeighbour(const REALVEC& position, F&& function) const
+{
+    forEachNeighbourCell( position, [&](std::size_t first, std::size_t last)
+    {
+        for( auto it = first; it != last; ++it )
+        {
+            function( entries[it] );
+        }
+    });
+}
+
+
+template<typename F>
+void CellList::forEachNeighbourCell(const REALVEC& position, F&& function) const
+{
+    if( entries.empty() ) return;
+
+    auto centre = cellCoordinates(position);
+    std::array<std::size_t, 3> xs {}, ys {}, zs {};
+    auto nx = neighbourCells(centre[0], nCells[0], xs);
+    auto ny = neighbourCells(centre[1], nCells[1], ys);
+    auto nz = neighbourCells(centre[2], nCells[2], zs);
+
+    for( std::size_t i = 0; i < nx; ++i )
+    {
+        for( std::size_t j = 0; j < ny; ++j )
+        {
+            for( std::size_t k = 0; k < nz; ++k )
+            {
+                auto cell = cellIndex(xs[i], ys[j], zs[k]);
+                if( cellStart[cell] != cellStart[cell+1] )  function( cellStart[cell], cellStart[cell+1] );
+            }
+        }
+    }
+}
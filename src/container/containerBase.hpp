@@ -19,6 +19,7 @@
 #pragma once
 
 #include <iterator>
+#include <utility>
 
 //
 // a container base class to derive from
@@ -68,5 +69,10 @@ struct ContainerBase
 
   protected:
     ContainerBase() = default;
+    explicit ContainerBase(T&& d) : data( std::move(d) ) {}
+    ContainerBase(const ContainerBase&) = default;
+    ContainerBase(ContainerBase&&) = default;
+    ContainerBase& operator=(const ContainerBase&) = default;
+    ContainerBase& operator=(ContainerBase&&) = default;
 
 };
\ No newline at end of file
@@ -0,0 +1,51 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "container/coordinateStore.hpp"
+
+//
+// append all atoms of a molecule
+//
+void CoordinateStore::addMolecule(const Molecule& molecule)
+{
+    for( const auto& atom: molecule )
+    {
+        positions.push_back( atom.position );
+        moleculeIDs.push_back( molecule.getID() );
+    }
+    offsets.push_back( moleculeIDs.size() );
+}
+
+
+//
+// overwrite the positions of a molecule that is still in place
+//
+bool CoordinateStore::updateMolecule(const std::size_t& m, const Molecule& molecule)
+{
+    if( m >= getNMolecules() || getLength(m) != molecule.size() )   return false;
+    const auto offset = offsets[m];
+    if( molecule.size() != 0 && moleculeIDs[offset] != molecule.getID() )   return false;
+
+    for( std::size_t a=0; a<molecule.size(); ++a )  positions.set( offset + a, molecule[a].position );
+    return true;
+}
+
+
+//
+// keep only the first n molecules
+//
+void CoordinateStore::truncate(const std::size_t& n)
+{
+    if( n >= getNMolecules() )  return;
+    offsets.resize( n + 1 );
+    positions.resize( offsets.back() );
+    moleculeIDs.resize( offsets.back() );
+}
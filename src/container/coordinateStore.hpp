@@ -0,0 +1,85 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "definitions.hpp"
+#include "container/molecule.hpp"
+#include "enhance/batchGeometry.hpp"
+
+#include <vector>
+
+//
+// coordinate store
+//
+// a contiguous structure-of-arrays copy of the atoms of a sequence of molecules:
+// positions (as a coordinate block) and molecule IDs per atom,
+// and per molecule the offset of its first atom, 
+// i.e. atom a of molecule m is found at getOffset(m) + a
+// (molecules that are still in place, i.e. same ID and number of atoms, can be updated in place,
+//  such that only their positions are written)
+//
+// (used for dense passes over many atoms, e.g. the geometry computations of the candidate search, 
+//  while Molecule / Atom remain the interface for everything else)
+//
+
+class CoordinateStore
+{
+    enhance::CoordinateBlock positions {};
+    std::vector<std::size_t> moleculeIDs {};
+    std::vector<std::size_t> offsets {0};   // first atom of each molecule (+ one past the last atom)
+
+  public:
+    //
+    // append all atoms of a molecule
+    //
+    void addMolecule(const Molecule&);
+
+    //
+    // overwrite the positions of molecule m with the ones of a molecule,
+    // returns false (without changing anything) if the molecule doesn't match molecule m (ID / number of atoms)
+    //
+    bool updateMolecule(const std::size_t&, const Molecule&);
+
+    //
+    // keep only the first n molecules
+    //
+    void truncate(const std::size_t&);
+
+    //
+    // getters per atom
+    //
+    inline REALVEC     getPosition(const std::size_t& i)   const { return positions[i]; }
+    inline std::size_t getMoleculeID(const std::size_t& i) const { return moleculeIDs[i]; }
+
+    //
+    // getters per molecule
+    //
+    inline std::size_t getOffset(const std::size_t& m) const { return offsets[m]; }
+    inline std::size_t getLength(const std::size_t& m) const { return offsets[m+1] - offsets[m]; }
+
+    //
+    // getters for the whole store
+    //
+    inline const auto& getPositions()  const { return positions; }
+    inline std::size_t getNAtoms()     const { return moleculeIDs.size(); }
+    inline std::size_t getNMolecules() const { return offsets.size() - 1; }
+
+    //
+    // clear store
+    //
+    inline void clear()
+    {
+        positions.clear();
+        moleculeIDs.clear();
+        offsets.assign( 1, 0 );
+    }
+};
@@ -51,7 +51,7 @@ bool Molecule::containsAtom(std::size_t id) const
     return (it == end() ? false : true);
 }
 
-bool Molecule::containsAtom(std::string name) const
+bool Molecule::containsAtom(const enhance::Symbol& name) const
 {
     auto it = std::find_if( begin(), end(), [&](auto& a){ return name == a.name; } );
     return (it == end() ? false : true);
@@ -16,36 +16,62 @@
 #include "container/atom.hpp"
 
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
 #include <functional>
+#include <limits>
 
 //
 // molecule container
 // 
 // derived from ContainerBase
 // contains atoms and all kind of useful methods that work with a molecule
+// (atoms are allocated via a polymorphic allocator, a molecule inside a container 
+//  with a polymorphic allocator, e.g. a topology, uses the memory resource of that container)
+// + the position of its first atom in the file it was read from (if it was read and not changed since)
 //
 
 class Molecule 
-    : public ContainerBase<std::vector<Atom>>
+    : public ContainerBase<std::pmr::vector<Atom>>
 {
     std::size_t molid    {0};
-    std::string molname  {};
+    enhance::Symbol molname {};
+    std::size_t record   {noRecord};
 
   public:
+    using allocator_type = std::pmr::polymorphic_allocator<Atom>;
+    static constexpr std::size_t noRecord {std::numeric_limits<std::size_t>::max()};
+
+    //
+    // constructors (+ allocator-extended versions)
+    //
+    Molecule() = default;
+    Molecule(const Molecule&) = default;
+    Molecule(Molecule&&) = default;
+    Molecule& operator=(const Molecule&) = default;
+    Molecule& operator=(Molecule&&) = default;
+    explicit Molecule(const allocator_type& alloc) 
+        : ContainerBase( std::pmr::vector<Atom>(alloc) ) {}
+    Molecule(const Molecule& other, const allocator_type& alloc) 
+        : ContainerBase( std::pmr::vector<Atom>(other.data, alloc) ), molid(other.molid), molname(other.molname), record(other.record) {}
+    Molecule(Molecule&& other, const allocator_type& alloc) 
+        : ContainerBase( std::pmr::vector<Atom>(std::move(other.data), alloc) ), molid(other.molid), molname(other.molname), record(other.record) {}
+
     //
     // getter/setter 
     //
     void        setID(std::size_t id)      { molid = id; }
-    void        setName(std::string  name) { molname = name; }
+    void        setName(const enhance::Symbol& name) { molname = name; }
     const auto& getID()      const { return molid; }
     const auto& getName()    const { return molname; }
+    void        setRecord(std::size_t r) { record = r; }
+    const auto& getRecord()  const { return record; }
 
     //
     // add new atoms to this molecule
     //
     inline auto addAtom(Atom a)                           { return data.emplace(end(), a); }
-    inline auto addAtom(std::size_t id, std::string name) { auto it = data.emplace(end()); it->id = id; it->name = name; return it; }
+    inline auto addAtom(std::size_t id, const enhance::Symbol& name) { auto it = data.emplace(end()); it->id = id; it->name = name; return it; }
 
     //
     // atom getters
@@ -63,7 +89,7 @@ class Molecule
     //
     bool containsAtom(Atom& element) const ;
     bool containsAtom(std::size_t id) const ;
-    bool containsAtom(std::string name) const;
+    bool containsAtom(const enhance::Symbol& name) const;
 
     //
     // check whether molecule contains any atoms
@@ -0,0 +1,86 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "container/neighbourList.hpp"
+
+//
+// (re)build neighbour list
+// (entries within the cutoff of each row are found via a cell list,
+//  the distances to all positions of a cell are computed at once by the batched kernels,
+//  only distances close to the cutoff are checked exactly)
+//
+void NeighbourList::build(const std::vector<REALVEC>& rows, const std::vector<REALVEC>& positions, const REALVEC& box, const REAL& cutoff)
+{
+    CellList cellList {};
+    cellList.build( positions, box, cutoff );
+
+    // positions in the order of the cells
+    enhance::CoordinateBlock block {};
+    for( auto ix: cellList.getEntries() )   block.push_back( positions[ix] );
+    std::vector<float> distancesSquared ( block.size() );
+
+    const double cutoffSquared = static_cast<double>(cutoff) * cutoff;
+    const double lowerSquared  = cutoffSquared * (1 - 1e-5);
+    const double upperSquared  = cutoffSquared * (1 + 1e-5);
+    const auto& cellEntries = cellList.getEntries();
+
+    rowStart.assign( 1, 0 );
+    entries.clear();
+    for( const auto& row: rows )
+    {
+        cellList.forEachNeighbourCell( row, [&](std::size_t first, std::size_t last)
+        {
+            enhance::batchDistancesSquared( row, block, first, last - first, box, distancesSquared.data() );
+            for( auto it = first; it != last; ++it )
+            {
+                const auto squared = distancesSquared[it - first];
+                if( squared > upperSquared )    continue;
+                if( squared >= lowerSquared && enhance::distance(row, positions[cellEntries[it]], box) > cutoff )   continue;
+                entries.emplace_back( cellEntries[it] );
+            }
+        });
+        std::sort( entries.begin() + rowStart.back(), entries.end() );
+        rowStart.emplace_back( entries.size() );
+    }
+    rsmdDEBUG( "built neighbour list with " << entries.size() << " entries for " << rows.size() << " rows (cutoff " << cutoff << ")" );
+}
+
+
+//
+// translate row and entry indices
+// (rows that are not mapped onto stay empty)
+//
+void NeighbourList::remap(const std::vector<std::size_t>& rowMap, const std::size_t& nNewRows, const std::vector<std::size_t>& entryMap)
+{
+    std::vector<std::size_t> oldRows( nNewRows, REMOVED );
+    for( std::size_t row=0; row<rowMap.size(); ++row )
+    {
+        if( rowMap[row] != REMOVED )    oldRows[rowMap[row]] = row;
+    }
+
+    std::vector<std::size_t> newRowStart( 1, 0 );
+    std::vector<std::size_t> newEntries {};
+    newEntries.reserve( entries.size() );
+    for( const auto& row: oldRows )
+    {
+        if( row != REMOVED )
+        {
+            for( auto it = rowStart[row]; it != rowStart[row+1]; ++it )
+            {
+                if( entryMap[entries[it]] != REMOVED )  newEntries.emplace_back( entryMap[entries[it]] );
+            }
+            std::sort( newEntries.begin() + newRowStart.back(), newEntries.end() );
+        }
+        newRowStart.emplace_back( newEntries.size() );
+    }
+    rowStart.swap( newRowStart );
+    entries.swap( newEntries );
+}
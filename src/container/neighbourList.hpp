@@ -0,0 +1,83 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "definitions.hpp"
+#include "container/cellList.hpp"
+#include "enhance/math_utility.hpp"
+#include "enhance/batchGeometry.hpp"
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+//
+// neighbour list container
+//
+// a Verlet-style list that holds for each row position (e.g. the anchor atoms of one
+// reactant) all entry positions (e.g. the linked atoms of another reactant) within a cutoff,
+// the cutoff is supposed to include a skin, such that the list stays valid
+// while no position moved by more than half of the skin
+//
+// rows and entries are stored as the indices of the positions given to build(),
+// the entries of each row are sorted
+//
+
+class NeighbourList
+{
+    std::vector<std::size_t> rowStart {};   // first entry of each row (+ one past the last entry)
+    std::vector<std::size_t> entries {};    // entry indices, sorted within each row
+
+  public:
+    //
+    // index used to mark removed rows/entries in remap()
+    //
+    static constexpr std::size_t REMOVED = std::numeric_limits<std::size_t>::max();
+
+    //
+    // (re)build neighbour list from row positions, entry positions, box and cutoff
+    //
+    void build(const std::vector<REALVEC>&, const std::vector<REALVEC>&, const REALVEC&, const REAL&);
+
+    //
+    // translate row and entry indices (old index -> new index or REMOVED),
+    // e.g. after molecules have been removed and renumbered
+    //
+    void remap(const std::vector<std::size_t>&, const std::size_t&, const std::vector<std::size_t>&);
+
+    //
+    // call function for all entries of a given row
+    //
+    template<typename F>
+    inline void forEachNeighbour(const std::size_t& row, F&& function) const
+    {
+        for( auto it = rowStart[row]; it != rowStart[row+1]; ++it )
+        {
+            function( entries[it] );
+        }
+    }
+
+    //
+    // some getters
+    //
+    inline auto size()  const { return entries.size(); }
+    inline auto nRows() const { return rowStart.empty() ? 0 : rowStart.size() - 1; }
+
+    //
+    // clear neighbour list
+    //
+    inline void clear()
+    {
+        rowStart.clear();
+        entries.clear();
+    }
+};
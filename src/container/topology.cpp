@@ -16,9 +16,58 @@
 //
 const std::size_t& Topology::getReactionRecordMolecule(const std::size_t& oldmolid) 
 {
-    auto it = std::find_if(reactedMoleculeRecords.begin(), reactedMoleculeRecords.end(), [&oldmolid](const auto& rec){ return rec.first == oldmolid; });
-    if( it == reactedMoleculeRecords.end() ) rsmdCRITICAL("couldn't find record for reacted molecule in topology: " << oldmolid);
-    return it->second;
+    auto it = reactedMoleculeIndices.find( oldmolid );
+    if( it == reactedMoleculeIndices.end() ) rsmdCRITICAL("couldn't find record for reacted molecule in topology: " << oldmolid);
+    return reactedMoleculeRecords[it->second].second;
+}
+
+//
+// rebuild the indices for all molecules from position first on
+// (if IDs are not unique, the first molecule with an ID is indexed)
+//
+void Topology::reindex(const std::size_t& first)
+{
+    if( first == 0 )
+    {
+        moleculeIndices.clear();
+        highestMoleculeID = 0;
+        moleculetypes.clear();
+        moleculetypeIndices.clear();
+    }
+    for( auto& members: moleculetypeIndices )
+    {
+        members.second.erase( std::lower_bound(members.second.begin(), members.second.end(), first), members.second.end() );
+    }
+
+    for( std::size_t i=first; i<data.size(); ++i )
+    {
+        auto inserted = moleculeIndices.emplace( data[i].getID(), i );
+        highestMoleculeID = std::max( highestMoleculeID, data[i].getID() );
+        if( ! inserted.second && inserted.first->second >= first )  inserted.first->second = std::min( inserted.first->second, i );
+
+        auto members = moleculetypeIndices.find( data[i].getName() );
+        if( members == moleculetypeIndices.end() )
+        {
+            moleculetypes.push_back( data[i].getName() );
+            members = moleculetypeIndices.emplace( data[i].getName(), std::vector<std::size_t> {} ).first;
+        }
+        members->second.push_back( i );
+    }
+
+    // remove moleculetypes without molecules
+    moleculetypes.erase( std::remove_if( moleculetypes.begin(), moleculetypes.end(), [&](const auto& mt)
+    {
+        auto members = moleculetypeIndices.find( mt );
+        if( ! members->second.empty() )     return false;
+        moleculetypeIndices.erase( members );
+        return true;
+    }), moleculetypes.end() );
+
+    // keep moleculetypes in order of first appearance
+    std::sort( moleculetypes.begin(), moleculetypes.end(), [&](const auto& lhs, const auto& rhs)
+    {
+        return moleculetypeIndices.find(lhs)->second.front() < moleculetypeIndices.find(rhs)->second.front();
+    });
 }
 
 //
@@ -27,53 +76,68 @@ const std::size_t& Topology::getReactionRecordMolecule(const std::size_t& oldmol
 const Molecule& Topology::getMolecule(std::size_t molid) const
 {
     // attention: assumes that molid is unique and thus returns first molecule that matches molid
-    auto it = std::find_if( begin(), end(), [&molid](auto& m){ return molid == m.getID(); } );
-    if( it == end() )   rsmdCRITICAL("couldn't find molecule in topology");
-    return std::cref(*it);
+    auto it = moleculeIndices.find( molid );
+    if( it == moleculeIndices.end() )   rsmdCRITICAL("couldn't find molecule in topology");
+    return std::cref(data[it->second]);
 }
 
-std::vector<std::reference_wrapper<Molecule>> Topology::getMolecules(std::string molname)
+std::vector<std::reference_wrapper<Molecule>> Topology::getMolecules(const enhance::Symbol& molname)
 {   
     // attention: returns all molecules that match molname
     std::vector<std::reference_wrapper<Molecule>> molReferences {};
-    for(auto it = begin(); it != end(); it++ )
+    for( const auto& i: getMoleculeIndices(molname) )
     {
-        if( it->getName() == molname )  molReferences.emplace_back( *it );
+        molReferences.emplace_back( data[i] );
     }
     return molReferences;
 }
 
+const std::vector<std::size_t>& Topology::getMoleculeIndices(const enhance::Symbol& molname) const
+{
+    static const std::vector<std::size_t> none {};
+    auto it = moleculetypeIndices.find( molname );
+    return ( it == moleculetypeIndices.end() ? none : it->second );
+}
+
 
 
 //
 // get specific molecule and add it if not existing yet
 //
-Molecule& Topology::getAddMolecule(std::size_t molid, std::string molname)
+Molecule& Topology::getAddMolecule(std::size_t molid, const enhance::Symbol& molname)
 {
     // attention: returns first molecule that matches molid (assumes that molid is unique)
-    auto it = std::find_if( begin(), end(), [&molid](auto& m){ return molid == m.getID(); } );
-    if( it == end() )
+    auto it = moleculeIndices.find( molid );
+    if( it == moleculeIndices.end() )
     {
         auto newIt = addMolecule( molid, molname );
         return std::ref(*newIt);
     }  
     else
-        return std::ref(*it);
+        return std::ref(data[it->second]);
 }
 
 
 
 //
 // remove specific molecule
+// (the positions of all following molecules change, so their index entries are updated)
 //
 void Topology::removeMolecule(Molecule& mol)
 {
-    data.erase( std::remove_if( begin(), end(), [&](auto& m){ return ( mol.getID() == m.getID() && mol.getName() == m.getName() ); } ), end() );
+    auto it = moleculeIndices.find( mol.getID() );
+    if( it == moleculeIndices.end() || data[it->second].getName() != mol.getName() )    return;
+    removeMolecule( mol.getID() );
 }
 
 void Topology::removeMolecule(std::size_t molid)
 {
-    data.erase( std::remove_if( begin(), end(), [&](auto& m){ return molid == m.getID(); } ), end() );
+    auto it = moleculeIndices.find( molid );
+    if( it == moleculeIndices.end() )   return;
+    const auto first = it->second;
+    data.erase( std::remove_if( begin() + first, end(), [&](auto& m){ return molid == m.getID(); } ), end() );
+    moleculeIndices.erase( it );
+    reindex( first );
 }
 
 //
@@ -81,77 +145,93 @@ void Topology::removeMolecule(std::size_t molid)
 //
 bool Topology::containsMolecule(const Molecule& mol) const
 {
-    const auto tmp = std::find_if( begin(), end(), [&](auto& m){ return ( mol.getID() == m.getID() && mol.getName() == m.getName() ); } );
-    if( tmp != end() )
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
+    const auto it = moleculeIndices.find( mol.getID() );
+    return ( it != moleculeIndices.end() && data[it->second].getName() == mol.getName() );
 }
 
 bool Topology::containsMolecule(const std::size_t& molid) const
 {
-    const auto tmp = std::find_if( begin(), end(), [&](auto& m){ return molid == m.getID(); } );
-    if( tmp != end() )
-    {
-        return true;
-    }
-    else
-    {
-        return false;
-    }
-
+    return ( moleculeIndices.find( molid ) != moleculeIndices.end() );
 }
 
 //
-// get moleculetypes
+// copy the positions of all atoms into the coordinate store:
+// molecules that are still in place are only updated, from the first molecule that moved
+// (or changed) on the store is rebuilt
 //
-std::vector<std::string> Topology::getMoleculetypes() const
+void Topology::syncCoordinates()
 {
-    std::vector<std::string> moleculetypes;
-    for( const auto& m: data )
-    {
-        auto it = std::find_if( moleculetypes.begin(), moleculetypes.end(), [&m](auto mt){ return mt == m.getName(); } );
-        if( it == moleculetypes.end() )    moleculetypes.push_back( m.getName() );
-    }
-    return moleculetypes;
-
+    std::size_t m = 0;
+    while( m < data.size() && coordinates.updateMolecule(m, data[m]) )  ++m;
+    coordinates.truncate( m );
+    for( ; m<data.size(); ++m )     coordinates.addMolecule( data[m] );
 }
 
 //
 // sort topology, i.e. rearrange and renumber everything (molecules + atoms)
+// note: a topology that was read from file is already sorted, i.e. usually only the products that were
+//       added at the end are out of place, so they are sorted and merged into the blocks of their moleculetypes
+//       and molecules / atoms are only renumbered from the first molecule whose numbering changed on
 //
 void Topology::sort()
 {
-    // clear atomic reaction records
+    // clear atomic reaction records and molecule ID changes
     reactedAtomRecords.clear();
+    sortedMoleculeRecords.clear();
+
+    // rearrange molecules according to name
+    // note:  stable sort / merge retain the order of equal elements!
+    // note:  names are compared via their rank among the (few) moleculetypes, instead of comparing strings
+    auto sortedMoleculetypes = moleculetypes;
+    std::sort( sortedMoleculetypes.begin(), sortedMoleculetypes.end(), [](const auto& lhs, const auto& rhs){ return lhs.str() < rhs.str(); });
+    std::unordered_map<enhance::Symbol, std::size_t> ranks {};
+    for( std::size_t i=0; i<sortedMoleculetypes.size(); ++i )  ranks.emplace( sortedMoleculetypes[i], i );
+    const auto compare = [&ranks](const auto& lhs, const auto& rhs){ return ranks.find(lhs.getName())->second < ranks.find(rhs.getName())->second; };
 
-    // sort (according to name) and renumber molecules
-    // then renumber atoms accordingly
-    // note:  use stable_sort instead of sort to retain order of equal elements!
-    std::stable_sort( begin(), end(), [](auto& lhs, auto& rhs){ return lhs.getName() < rhs.getName(); });
+    std::size_t firstMoved = data.size();
+    const auto unsorted = std::is_sorted_until( begin(), end(), compare );
+    if( unsorted != end() )
+    {
+        std::stable_sort( unsorted, end(), compare );
+        firstMoved = std::distance( begin(), std::upper_bound( begin(), unsorted, *unsorted, compare ) );
+        std::inplace_merge( begin(), unsorted, end(), compare );
+    }
     
+    // renumber molecules and atoms
+    // (up to the first molecule whose ID or atom IDs do not match the numbering, nothing changes)
     std::size_t counterMolecules = 0;
     std::size_t counterAtoms = 0;
+    bool renumber = false;
     for( auto& m: data )
     {
-        // renumber molecules
         ++ counterMolecules;
+        if( ! renumber && ( m.getID() != counterMolecules || ( ! m.empty() && m.front().id != counterAtoms + 1 ) ) )
+        {
+            renumber = true;
+            sortedUnchanged = counterMolecules - 1;
+        }
+
         // check if this is a newly reacted molecule
-        bool isReactedMolecule = false;
-        auto search = std::find_if(std::begin(reactedMoleculeRecords), std::end(reactedMoleculeRecords), [&m](const auto& record){return m.getID() == record.first; });
-        if( search != std::end(reactedMoleculeRecords) )
+        auto search = reactedMoleculeIndices.find( m.getID() );
+        const bool isReactedMolecule = ( search != reactedMoleculeIndices.end() );
+        if( isReactedMolecule )     reactedMoleculeRecords[search->second].second = counterMolecules;
+
+        // index entries of moved / renumbered molecules are rebuilt
+        if( renumber || counterMolecules > firstMoved )     moleculeIndices.erase( m.getID() );
+
+        if( ! renumber )
         {
-            isReactedMolecule = true;
-            search->second = counterMolecules;
+            // record (unchanged) atom IDs if reactedMolecule
+            if( isReactedMolecule ) for( const auto& a: m ) reactedAtomRecords.emplace_back( a.id, a.id );
+            counterAtoms += m.size();
+            continue;
         }
+
         // reset ID
         #ifndef NDEBUG
         if( m.getID() != counterMolecules ){ rsmdDEBUG("note: resetting ID of " << m << " to " << counterMolecules); }
         #endif
+        sortedMoleculeRecords.emplace_back( m.getID(), counterMolecules );
         m.setID(counterMolecules);
         // renumber atoms in molecule
         for( auto& a: m )
@@ -166,6 +246,11 @@ void Topology::sort()
             a.id = counterAtoms;
         }
     }
+    if( ! renumber )    sortedUnchanged = counterMolecules;
+
+    // molecules were rearranged and renumbered
+    reindex( std::min( firstMoved, sortedUnchanged ) );
+    highestMoleculeID = data.size();
 }
 
 //
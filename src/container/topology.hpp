@@ -13,10 +13,13 @@
 
 #include "container/containerBase.hpp"
 #include "container/molecule.hpp"
+#include "container/coordinateStore.hpp"
 
 #include <vector>
+#include <memory_resource>
 #include <algorithm>
 #include <numeric>
+#include <unordered_map>
 
 //
 // topology container
@@ -24,45 +27,113 @@
 // derived from ContainerBase
 // contains molecules and all kind of useful methods that work with/on these molecules
 //          + box dimensions
+//          + an index from molecule ID to position in the container (+ the highest molecule ID)
+//          + the moleculetypes (in order of first appearance) and the positions of their molecules
+//            (both kept up to date by all methods that add, remove or renumber molecules)
+//          + a contiguous copy of the positions of all atoms in a coordinate store
+//            (only updated on request, i.e. a snapshot of the latest call to syncCoordinates())
+//          + records of reacted molecules (indexed by their ID before sorting)
+//            and of the molecule IDs that changed in the latest sort
+//
+// molecules, their atoms and the index of molecule IDs are allocated from a memory resource
+// (given on construction, e.g. an arena that is reset every cycle, cf. release())
 //
 
 class Topology
-    : public ContainerBase< std::vector<Molecule> >
+    : public ContainerBase< std::pmr::vector<Molecule> >
 {
     REALVEC dimensions {0, 0, 0};
     std::vector<std::pair<std::size_t, std::size_t>> reactedMoleculeRecords {};
+    std::unordered_map<std::size_t, std::size_t> reactedMoleculeIndices {};
     std::vector<std::pair<std::size_t, std::size_t>> reactedAtomRecords {};
+    std::vector<std::pair<std::size_t, std::size_t>> sortedMoleculeRecords {};
+    std::size_t sortedUnchanged {0};
+    std::pmr::unordered_map<std::size_t, std::size_t> moleculeIndices {};
+    std::size_t highestMoleculeID {0};
+    std::size_t source {0};
+    std::vector<enhance::Symbol> moleculetypes {};
+    std::unordered_map<enhance::Symbol, std::vector<std::size_t>> moleculetypeIndices {};
+    CoordinateStore coordinates {};
+
+    //
+    // add the molecule at the given position to the indices
+    //
+    inline void indexMolecule(const std::size_t& i)
+    {
+        moleculeIndices.emplace( data[i].getID(), i );
+        highestMoleculeID = std::max( highestMoleculeID, data[i].getID() );
+        auto members = moleculetypeIndices.find( data[i].getName() );
+        if( members == moleculetypeIndices.end() )
+        {
+            moleculetypes.push_back( data[i].getName() );
+            members = moleculetypeIndices.emplace( data[i].getName(), std::vector<std::size_t> {} ).first;
+        }
+        members->second.push_back( i );
+    }
+
+    //
+    // rebuild the indices, starting with the given position
+    //
+    void reindex(const std::size_t& first = 0);
 
   public:
+    //
+    // constructors
+    // (with the memory resource to allocate molecules from, default: the default memory resource)
+    //
+    Topology() = default;
+    explicit Topology(std::pmr::memory_resource* resource) 
+        : ContainerBase( std::pmr::vector<Molecule>(resource) ), moleculeIndices( resource ) {}
+
     //
     // getter/setter for dimensions
     //
     inline void        setDimensions(const REALVEC& d) { dimensions = d; }
     inline const auto& getDimensions()    const { return dimensions; }
 
+    //
+    // getter/setter for the source of the molecules, i.e. an identifier of the file 
+    // they were read from, to which the records of the molecules refer (0: none)
+    //
+    inline void        setSource(const std::size_t& s) { source = s; }
+    inline const auto& getSource()        const { return source; }
+
     //
     // getter/setter for reaction records
     //
     inline void        addReactionRecord(const std::size_t& molid) 
     { 
+        reactedMoleculeIndices.emplace(molid, reactedMoleculeRecords.size());
         reactedMoleculeRecords.emplace_back(std::make_pair(molid, 0)); 
     }
     inline const auto& getReactionRecordsAtoms()     { return reactedAtomRecords; }
     inline const auto& getReactionRecordsMolecules() { return reactedMoleculeRecords; }
+
+    //
+    // getters for the molecule ID changes of the latest sort:
+    // molecules with IDs up to getSortUnchanged() kept their ID, 
+    // all others are listed in the sort records (old ID, new ID)
+    //
+    inline const auto& getSortRecordsMolecules() const { return sortedMoleculeRecords; }
+    inline const auto& getSortUnchanged()        const { return sortedUnchanged; }
     const std::size_t& getReactionRecordMolecule(const std::size_t& oldmolid);
 
     //
     // add new molecules to this topology
+    // (copies are constructed once, directly with the memory resource of the topology)
     //
-    inline auto addMolecule(Molecule m)    
+    inline auto addMolecule(const Molecule& m)    
     { 
-        return data.emplace(end(), m); 
+        auto it = data.emplace(end(), m); 
+        indexMolecule( data.size() - 1 );
+        return it;
     }
-    inline auto addMolecule(std::size_t id, std::string name) 
+    inline auto addMolecule(std::size_t id, const enhance::Symbol& name) 
     { 
         auto it = data.emplace(end()); 
         it->setID(id); 
         it->setName(name); 
+        indexMolecule( data.size() - 1 );
         return it; 
     }
 
@@ -82,17 +153,33 @@ class Topology
     // get specific molecules
     //
     const Molecule& getMolecule(std::size_t) const;
-    std::vector<std::reference_wrapper<Molecule>> getMolecules(std::string);
+    std::vector<std::reference_wrapper<Molecule>> getMolecules(const enhance::Symbol&);
 
     // 
     // get specific molecule, create it if not yet existing
     //
-    Molecule& getAddMolecule(std::size_t, std::string);
+    Molecule& getAddMolecule(std::size_t, const enhance::Symbol&);
+
+    //
+    // get positions / number of molecules of a moleculetype
+    //
+    const std::vector<std::size_t>& getMoleculeIndices(const enhance::Symbol&) const;
+    inline std::size_t getNMolecules(const enhance::Symbol& molname) const
+    {
+        return getMoleculeIndices(molname).size();
+    }
 
     //
-    // get moleculetypes
+    // get the highest molecule ID 
+    // (maintained while adding molecules, i.e. an upper bound after molecules were removed,
+    //  and exact for topologies that were read or sorted)
     //
-    std::vector<std::string> getMoleculetypes() const;
+    inline const auto& getHighestMoleculeID() const { return highestMoleculeID; }
+
+    //
+    // get moleculetypes (in order of first appearance)
+    //
+    inline const auto& getMoleculetypes() const { return moleculetypes; }
 
     //
     // get # of atoms
@@ -102,8 +189,16 @@ class Topology
         return std::accumulate( begin(), end(), 0, [](int counter, const auto& m){ return counter + m.size(); } ); 
     }
 
+    //
+    // copy the positions of all atoms into the coordinate store / get the coordinate store
+    // (molecule m of the topology is molecule m of the store)
+    //
+    void syncCoordinates();
+    inline const auto& getCoordinates() const { return coordinates; }
+
     //
     // sort topology, i.e. rearrange and renumber everything
+    // (only the molecules that are out of place are moved, and only the ones from the first changed ID on are renumbered)
     //
     void sort();
 
@@ -128,14 +223,36 @@ class Topology
     inline void clear() 
     { 
         data.clear(); 
+        moleculeIndices.clear();
+        highestMoleculeID = 0;
+        moleculetypes.clear();
+        moleculetypeIndices.clear();
+        coordinates.clear();
+        source = 0;
         dimensions.setZero(); 
         reactedAtomRecords.clear(); 
         reactedMoleculeRecords.clear();
+        reactedMoleculeIndices.clear();
+        sortedMoleculeRecords.clear();
+        sortedUnchanged = 0;
+    }
+    //
+    // clear topology and give all memory back to the memory resource
+    // (has to be called before an arena, from which the topology allocated, is reset)
+    //
+    inline void release()
+    {
+        clear();
+        std::pmr::vector<Molecule>( data.get_allocator() ).swap( data );
+        std::pmr::unordered_map<std::size_t, std::size_t>( moleculeIndices.get_allocator() ).swap( moleculeIndices );
     }
     inline void clearReactionRecords() 
     { 
         reactedMoleculeRecords.clear(); 
+        reactedMoleculeIndices.clear();
         reactedAtomRecords.clear(); 
+        sortedMoleculeRecords.clear();
+        sortedUnchanged = 0;
     }
 
     //
@@ -0,0 +1,93 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "container/topologyDelta.hpp"
+
+//
+// start recording changes for a base topology
+//
+void TopologyDelta::reset(const Topology& topology)
+{
+    base = &topology;
+    removed.clear();
+    added.clear();
+    addedIndices.clear();
+    highestID = topology.getHighestMoleculeID();
+}
+
+
+//
+// remove molecule (an added one, or one of the base topology)
+//
+void TopologyDelta::removeMolecule(const std::size_t& molid)
+{
+    auto it = addedIndices.find( molid );
+    if( it != addedIndices.end() )
+    {
+        const auto first = it->second;
+        added.erase( added.begin() + first );
+        addedIndices.erase( it );
+        for( std::size_t i=first; i<added.size(); ++i )    addedIndices[added[i].getID()] = i;
+    }
+    else if( base->containsMolecule(molid) )
+    {
+        removed.insert( molid );
+    }
+}
+
+
+//
+// add molecule
+//
+const Molecule& TopologyDelta::addMolecule(const Molecule& molecule)
+{
+    addedIndices.emplace( molecule.getID(), added.size() );
+    added.push_back( molecule );
+    highestID = std::max( highestID, molecule.getID() );
+    return added.back();
+}
+
+
+//
+// check if specific molecule exists in the changed topology
+//
+bool TopologyDelta::containsMolecule(const Molecule& molecule) const
+{
+    auto it = addedIndices.find( molecule.getID() );
+    if( it != addedIndices.end() )  return added[it->second].getName() == molecule.getName();
+    return removed.count( molecule.getID() ) == 0 && base->containsMolecule( molecule );
+}
+
+bool TopologyDelta::containsMolecule(const std::size_t& molid) const
+{
+    if( addedIndices.find( molid ) != addedIndices.end() )  return true;
+    return removed.count( molid ) == 0 && base->containsMolecule( molid );
+}
+
+
+//
+// create the changed topology
+//
+void TopologyDelta::materialize(Topology& topology) const
+{
+    topology.clear();
+    topology.setDimensions( base->getDimensions() );
+    topology.setSource( base->getSource() );
+    for( const auto& molecule: *base )
+    {
+        if( removed.count( molecule.getID() ) == 0 )    topology.addMolecule( molecule );
+    }
+    for( const auto& molecule: added )
+    {
+        topology.addMolecule( molecule );
+        topology.addReactionRecord( molecule.getID() );
+    }
+}
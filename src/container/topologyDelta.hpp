@@ -0,0 +1,83 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "container/topology.hpp"
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+//
+// topology delta
+//
+// the changes of a topology, recorded on top of a base topology (which is not modified):
+// - IDs of removed molecules of the base topology
+// - added molecules (in order of addition)
+// the changed topology is only created on request (materialize)
+//
+
+class TopologyDelta
+{
+    const Topology* base {nullptr};
+    std::unordered_set<std::size_t> removed {};
+    std::vector<Molecule> added {};
+    std::unordered_map<std::size_t, std::size_t> addedIndices {};
+    std::size_t highestID {0};
+
+  public:
+    //
+    // start recording changes for a base topology
+    //
+    void reset(const Topology&);
+
+    //
+    // remove / add molecules
+    //
+    void removeMolecule(const std::size_t&);
+    const Molecule& addMolecule(const Molecule&);
+
+    //
+    // reserve memory for the given number of added molecules
+    //
+    inline void reserve(const std::size_t& n)
+    {
+        added.reserve( added.size() + n );
+        addedIndices.reserve( addedIndices.size() + n );
+    }
+
+    //
+    // check if specific molecule exists in the changed topology
+    //
+    bool containsMolecule(const Molecule&) const;
+    bool containsMolecule(const std::size_t&) const;
+
+    //
+    // highest molecule ID in the changed topology
+    // (including the IDs of removed molecules, such that no ID is reused)
+    //
+    inline const auto& getHighestMoleculeID() const { return highestID; }
+
+    //
+    // create the changed topology:
+    // all remaining molecules of the base topology in their order, followed by the added molecules,
+    // with reaction records for all added molecules
+    //
+    void materialize(Topology&) const;
+
+    //
+    // some getters
+    //
+    inline const auto& getAdded()   const { return added; }
+    inline const auto& getRemoved() const { return removed; }
+    inline bool        empty()      const { return added.empty() && removed.empty(); }
+};
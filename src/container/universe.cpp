@@ -19,13 +19,17 @@ void Universe::setup(const Parameters& parameters)
     switch( parameters.getEngineType() )
     {
         case ENGINE::GROMACS:   
-            topologyParser = std::make_unique<TopologyParserGMX>();
+        {
+            auto parserGMX = std::make_unique<TopologyParserGMX>();
+            parserGMX->setRefineCoordinates( parameters.getOption("gromacs.refineCoordinates").as<bool>() );
+            topologyParser = std::move( parserGMX );
             assert(topologyParser);
 
             unitSystem = std::make_unique<UnitSystem>("nm", "ps", "kJ/mol", "K");
             assert(unitSystem);
 
             break;
+        }
 
         case ENGINE::NONE:
             rsmdCRITICAL( "md engine is set to none" );
@@ -67,41 +71,344 @@ void Universe::setup(const Parameters& parameters)
         
         reactionTemplates.emplace_back(reaction);
     }
+
+    // setup links between reactants for the candidate search
+    setupReactantLinks();
+
+    // number of threads for the candidate search
+    nThreads = parameters.getOption("reaction.threads").as<std::size_t>();
+    if( nThreads == 0 ) nThreads = std::max( 1u, std::thread::hardware_concurrency() );
+    rsmdLOG( "... using " << nThreads << " thread(s) for the reaction candidate search and for reading coordinates" );
+    topologyParser->setThreads( nThreads );
+    rsmdLOG( "... using " << enhance::to_string(enhance::getInstructionSet()) << " kernels for batched geometry computations" );
+
+    // skin for the neighbour lists of the candidate search
+    skin = parameters.getOption("reaction.skin").as<REAL>();
+    neighbourListsBuilt = false;
+    sortedMoleculeIDsValid = false;
+
+    // keep topology and candidate search structures after rejected reactive steps
+    reuseTopology = parameters.getOption("reaction.reuseTopology").as<bool>();
+    topologyRead = false;
+}
+
+
+//
+// setup links between reactants of all reaction templates:
+// reactant k is linked to an earlier reactant if a distance criterion connects both
+// (the tightest such criterion is used),
+// the atoms of linked reactants and their anchors are tracked for the neighbour list update
+//
+void Universe::setupReactantLinks()
+{
+    reactantLinks.clear();
+    trackedAtoms.clear();
+    criterionPrograms.clear();
+    reactantCounts.clear();
+    for( const auto& reactionTemplate: reactionTemplates )
+    {
+        const auto& reactants = reactionTemplate.getReactants();
+        std::vector<ReactantLink> links( reactants.size() );
+        for( const auto& criterion: reactionTemplate.getCriterions() )
+        {
+            if( criterion->getType() != "distance" ) continue;
+
+            // note: atom indices in reaction templates are translated to atom indices
+            // in the topology molecules via the atom ID (cf. ReactionCandidate::updateReactant)
+            auto first  = (*criterion)[0];
+            auto second = (*criterion)[1];
+            if( first.first == second.first ) continue;
+            if( first.first < second.first )    std::swap(first, second);
+            
+            auto& link = links[first.first];
+            if( ! link.linked || criterion->getMax() < link.cutoff )
+            {
+                link.linked = true;
+                link.anchor = second.first;
+                link.anchorAtom = reactants[second.first][second.second].id - 1;
+                link.atom = reactants[first.first][first.second].id - 1;
+                link.cutoff = criterion->getMax();
+            }
+        }
+        reactantLinks.emplace_back( links );
+
+        // atoms for which displacements are tracked
+        trackedAtoms.emplace_back( reactants.size() );
+        auto track = [&](const std::size_t& k, const std::size_t& atom)
+        {
+            auto& atoms = trackedAtoms.back()[k];
+            if( std::find(atoms.begin(), atoms.end(), atom) == atoms.end() )    atoms.emplace_back( atom );
+        };
+        for( std::size_t k=0; k<links.size(); ++k )
+        {
+            if( ! links[k].linked ) continue;
+            rsmdDEBUG( "cutoff for candidate search of reaction " << reactionTemplate.getName() << ": " << links[k].cutoff );
+            track( k, links[k].atom );
+            track( links[k].anchor, links[k].anchorAtom );
+        }
+
+        // compile criterions
+        criterionPrograms.emplace_back();
+        criterionPrograms.back().compile( reactionTemplate );
+        reactantCounts.push_back( reactionTemplate.getReactants().size() );
+    }
+}
+
+
+//
+// update neighbour lists for all linked reactants (after topologyOld has been read):
+// the lists of the previous cycle are kept if they refer to the same molecules (possibly
+// renumbered according to the latest sort of a written topology) and no tracked atom 
+// moved by more than half of the skin, else they are rebuilt
+//
+void Universe::updateNeighbourLists(const std::size_t& cycle)
+{
+    // note: the molecules of a cycle (and their order in topologyOld) are always the same
+    const bool sameMolecules = neighbourListsBuilt && cycle == neighbourListCycle;
+    if( ! sameMolecules )
+    {
+        reactantMolecules.clear();
+        for( const auto& reactionTemplate: reactionTemplates )
+        {
+            const auto& reactants = reactionTemplate.getReactants();
+            reactantMolecules.emplace_back( reactants.size() );
+            for( std::size_t k=0; k<reactants.size(); ++k )
+            {
+                reactantMolecules.back()[k] = topologyOld.getMoleculeIndices( reactants[k].getName() );
+            }
+        }
+    }
+
+    const bool renumbered    = neighbourListsBuilt && ! sameMolecules && sortedMoleculeIDsValid && cycle == sortedCycle;
+    const auto& box = topologyOld.getDimensions();
+    const bool sameBox       = neighbourListsBuilt && neighbourListBox[0] == box[0] && neighbourListBox[1] == box[1] && neighbourListBox[2] == box[2];
+    if( ! neighbourListsBuilt )
+    {
+        neighbourLists.assign( reactionTemplates.size(), {} );
+        referencePositions.assign( reactionTemplates.size(), {} );
+        neighbourListIDs.assign( reactionTemplates.size(), {} );
+    }
+
+    for( std::size_t t=0; t<reactionTemplates.size(); ++t )
+    {
+        bool rebuild = ! sameBox || ! ( sameMolecules || renumbered );
+        if( ! rebuild && renumbered )   rebuild = ! remapNeighbourLists(t);
+        if( ! rebuild )
+        {
+            for( std::size_t k=0; k<reactantMolecules[t].size(); ++k )
+            {
+                if( neighbourListIDs[t][k].size() != reactantMolecules[t][k].size() )   rebuild = true;
+            }
+        }
+        if( ! rebuild )
+        {
+            auto displacement = maxDisplacement(t);
+            rsmdDEBUG( "maximum displacement since last neighbour list build for reaction " << reactionTemplates[t].getName() << ": " << displacement );
+            rebuild = ( displacement > 0.5 * skin );
+        }
+
+        if( rebuild )
+        {
+            rsmdDEBUG( "rebuilding neighbour lists for reaction " << reactionTemplates[t].getName() );
+            buildNeighbourLists(t);
+        }
+    }
+
+    neighbourListBox = box;
+    neighbourListCycle = cycle;
+    neighbourListsBuilt = true;
+}
+
+
+//
+// (re)build neighbour lists for all linked reactants of reaction template t from topologyOld
+//
+void Universe::buildNeighbourLists(const std::size_t& t)
+{
+    const auto& molecules = reactantMolecules[t];
+    const auto& box = topologyOld.getDimensions();
+    const auto& coordinates = topologyOld.getCoordinates();
+
+    neighbourLists[t].assign( molecules.size(), {} );
+    referencePositions[t].assign( molecules.size(), {} );
+    neighbourListIDs[t].assign( molecules.size(), {} );
+    std::vector<REALVEC> rows {};
+    std::vector<REALVEC> positions {};
+    for( std::size_t k=0; k<molecules.size(); ++k )
+    {
+        for( const auto& i: molecules[k] )
+        {
+            neighbourListIDs[t][k].emplace_back( topologyOld[i].getID() );
+            for( const auto& atom: trackedAtoms[t][k] )
+            {
+                referencePositions[t][k].emplace_back( coordinates.getPosition(coordinates.getOffset(i) + atom) );
+            }
+        }
+
+        const auto& link = reactantLinks[t][k];
+        if( ! link.linked ) continue;
+
+        rows.clear();
+        positions.clear();
+        for( const auto& i: molecules[link.anchor] )    rows.emplace_back( coordinates.getPosition(coordinates.getOffset(i) + link.anchorAtom) );
+        for( const auto& i: molecules[k] )              positions.emplace_back( coordinates.getPosition(coordinates.getOffset(i) + link.atom) );
+        neighbourLists[t][k].build( rows, positions, box, link.cutoff + skin );
+    }
+}
+
+
+//
+// translate neighbour lists of reaction template t to the renumbered molecules in topologyOld,
+// returns false if this is not possible (i.e. if there are new molecules)
+//
+bool Universe::remapNeighbourLists(const std::size_t& t)
+{
+    const auto& molecules = reactantMolecules[t];
+
+    // old index -> new index for all reactants
+    std::vector<std::vector<std::size_t>> indexMaps( molecules.size() );
+    for( std::size_t k=0; k<molecules.size(); ++k )
+    {
+        std::unordered_map<std::size_t, std::size_t> newIndices {};
+        for( std::size_t i=0; i<molecules[k].size(); ++i )
+        {
+            newIndices.emplace( topologyOld[molecules[k][i]].getID(), i );
+        }
+
+        std::size_t nMapped = 0;
+        indexMaps[k].assign( neighbourListIDs[t][k].size(), NeighbourList::REMOVED );
+        for( std::size_t i=0; i<neighbourListIDs[t][k].size(); ++i )
+        {
+            auto id = neighbourListIDs[t][k][i];
+            if( id > sortedUnchanged )
+            {
+                auto sorted = sortedMoleculeIDs.find( id );
+                if( sorted == sortedMoleculeIDs.end() ) continue;
+                id = sorted->second;
+            }
+            auto found = newIndices.find( id );
+            if( found == newIndices.end() ) continue;
+            indexMaps[k][i] = found->second;
+            ++ nMapped;
+        }
+        if( nMapped != molecules[k].size() )    return false;
+    }
+
+    // translate everything
+    for( std::size_t k=0; k<molecules.size(); ++k )
+    {
+        const auto nTracked = trackedAtoms[t][k].size();
+        std::vector<std::size_t> ids ( molecules[k].size() );
+        std::vector<REALVEC> positions ( molecules[k].size() * nTracked );
+        for( std::size_t i=0; i<indexMaps[k].size(); ++i )
+        {
+            const auto& ix = indexMaps[k][i];
+            if( ix == NeighbourList::REMOVED )  continue;
+            ids[ix] = topologyOld[molecules[k][ix]].getID();
+            std::copy( referencePositions[t][k].begin() + i * nTracked, referencePositions[t][k].begin() + (i + 1) * nTracked, positions.begin() + ix * nTracked );
+        }
+        neighbourListIDs[t][k].swap( ids );
+        referencePositions[t][k].swap( positions );
+
+        const auto& link = reactantLinks[t][k];
+        if( link.linked )   neighbourLists[t][k].remap( indexMaps[link.anchor], molecules[link.anchor].size(), indexMaps[k] );
+    }
+    return true;
+}
+
+
+//
+// maximum displacement of all tracked atoms of reaction template t since the last build of its neighbour lists
+//
+REAL Universe::maxDisplacement(const std::size_t& t) const
+{
+    REAL displacement {0};
+    const auto& box = topologyOld.getDimensions();
+    const auto& coordinates = topologyOld.getCoordinates();
+    for( std::size_t k=0; k<reactantMolecules[t].size(); ++k )
+    {
+        const auto& atoms = trackedAtoms[t][k];
+        for( std::size_t i=0; i<reactantMolecules[t][k].size(); ++i )
+        {
+            const auto offset = coordinates.getOffset( reactantMolecules[t][k][i] );
+            for( std::size_t a=0; a<atoms.size(); ++a )
+            {
+                displacement = std::max( displacement, enhance::distance(coordinates.getPosition(offset + atoms[a]), referencePositions[t][k][i * atoms.size() + a], box) );
+            }
+        }
+    }
+    return displacement;
 }
 
 
 // 
 // update topologies
+// (if the topology of the same cycle has been read before, i.e. the last reactive step was rejected,
+//  and reuseTopology is set, the molecules of topologyOld are kept and only their positions are refreshed)
+// the memory of all topologies that are rebuilt is released at once by resetting their arenas
 //
 void Universe::update(const std::size_t& cycle) 
 {
-    topologyOld.clear();
-    topologyNew.clear();
-    topologyRelaxed.clear();
+    topologyNew.release();
+    topologyRelaxed.release();
+    cycleArena.reset();
+    relaxedRead = false;
+    batchCandidates.clear();
+    batchReacted.clear();
+
+    bool refreshed = false;
+    if( reuseTopology && topologyRead && cycle == topologyCycle )
+    {
+        refreshed = topologyParser->readCoordinates(topologyOld, cycle);
+        if( ! refreshed )   rsmdWARNING( "coordinates of cycle " << cycle << " don't match the previous topology, reading the full topology" );
+    }
+    if( ! refreshed )
+    {
+        topologyOld.release();
+        topologyArena.reset();
+        topologyParser->read(topologyOld, cycle);
+        topologyOld.clearReactionRecords();
+    }
+    topologyOld.syncCoordinates();
+    topologyDelta.reset(topologyOld);
+    topologyCycle = cycle;
+    topologyRead = true;
 
-    topologyParser->read(topologyOld, cycle);
-    topologyOld.clearReactionRecords();
-    topologyNew = topologyOld;
+    updateNeighbourLists(cycle);
 }
 
 
 //
 // write (new) topology to file 
+// (after creating it from topologyOld and the recorded changes)
 //
 void Universe::write(const std::size_t& cycle)
 {
+    topologyDelta.materialize(topologyNew);
     topologyNew.sort();
     topologyParser->write(topologyNew, cycle);
+
+    // remember ID changes, in order to reuse neighbour lists for the written topology
+    sortedMoleculeIDs.clear();
+    for( const auto& record: topologyNew.getSortRecordsMolecules() )
+    {
+        sortedMoleculeIDs.emplace( record.first, record.second );
+    }
+    sortedUnchanged = topologyNew.getSortUnchanged();
+    sortedCycle = cycle;
+    sortedMoleculeIDsValid = true;
 }
 
 
 //
 // read relaxed configuration from file
+// (deferred until checkMovement() needs it)
 //
 void Universe::readRelaxed(const std::size_t& cycle)
 {
     topologyRelaxed.clear();
-    topologyParser->readRelaxed(topologyRelaxed, cycle);
+    relaxedCycle = cycle;
+    relaxedRead = false;
 }
 
 
@@ -117,6 +424,15 @@ void Universe::checkMovement(const ReactionCandidate& candidate)
     // REAL typicalDistance = std::sqrt( (3.0 * volume) / (4.0 * M_PI * topologyNew.getNAtoms()) );
     REAL typicalDistance = std::cbrt( (3.0 * volume) / (4.0 * M_PI * topologyNew.getNAtoms()) );
 
+    // read the relaxed configuration of all products (on first use)
+    if( ! relaxedRead )
+    {
+        std::unordered_set<std::size_t> productIDs {};
+        for( const auto& record: topologyNew.getReactionRecordsMolecules() )  productIDs.insert( record.second );
+        topologyParser->readRelaxed(topologyRelaxed, relaxedCycle, productIDs);
+        relaxedRead = true;
+    }
+
     for( auto& molecule: candidate.getProducts() )
     {
         // get same molecule in topologyRelaxed
@@ -154,20 +470,29 @@ void Universe::checkMovement(const ReactionCandidate& candidate)
 
 //
 // check if a candidate is still available
+// (conflicting candidates are marked when a candidate is added to the reaction batch)
 //
-bool Universe::isAvailable( const ReactionCandidate& candidate )
+bool Universe::isAvailable( const CandidateHandle& candidate )
 {
-    bool reactantsAreAvailable = true;
-    for( const auto& reactant: candidate.getReactants() )
+    return reactionCandidates.isAvailable(candidate);
+}
+
+
+//
+// create the full reaction candidate for a candidate handle
+// (from the reaction template and the reactant molecules in topologyOld)
+//
+ReactionCandidate Universe::getReactionCandidate( const CandidateHandle& candidate ) const
+{
+    ReactionCandidate reactionCandidate( reactionTemplates[candidate.reaction] );
+    const auto* molecules = reactionCandidates.getMolecules(candidate);
+    for( std::size_t k=0; k<reactionCandidate.getReactants().size(); ++k )
     {
-        if( ! topologyNew.containsMolecule(reactant) )
-        {
-            rsmdDEBUG( "couldn't find molecule " << reactant.getName() << " " << reactant.getID() << " in topology" );
-            reactantsAreAvailable = false;
-            break;
-        }
+        reactionCandidate.updateReactant( k, topologyOld[molecules[k]] );
     }
-    return reactantsAreAvailable;
+    // evaluate criterions once more in order to set their latest values
+    reactionCandidate.valid( topologyOld.getDimensions() );
+    return reactionCandidate;
 }
 
 void Universe::makeMoleculeWhole(Molecule& molecule, const REALVEC& dimensions)
@@ -194,10 +519,9 @@ void Universe::makeMoleculeWhole(Molecule& molecule, const REALVEC& dimensions)
 }
 
 //
-// react a given candidate
-// (checks for whether the molecules are still available need to happen before!)
+// create the products of a candidate
 //
-void Universe::react(ReactionCandidate& candidate)
+void Universe::prepareReaction(ReactionCandidate& candidate)
 {
     rsmdDEBUG( "performing reaction for candidate " << candidate.shortInfo() );
    
@@ -206,99 +530,396 @@ void Universe::react(ReactionCandidate& candidate)
     // make products whole
     for(auto& product: candidate.getProducts())
     {
-        makeMoleculeWhole(product, topologyNew.getDimensions());
+        makeMoleculeWhole(product, topologyOld.getDimensions());
     }
     // apply translational movements of product atoms
     candidate.applyTranslations();
+}
 
-    // apply changes to topology
-    auto highestMolID = std::max_element( std::begin(topologyNew), std::end(topologyNew), [](const auto& mol1, const auto& mol2){ return mol1.getID() < mol2.getID(); } )->getID(); 
+
+//
+// record changes to topology
+// (reaction records for the products are added when the new topology is created)
+//
+void Universe::recordReaction(ReactionCandidate& candidate, std::size_t& highestMolID)
+{
     for( const auto& reactant: candidate.getReactants() )
     {
-        topologyNew.removeMolecule( reactant.getID() );    
+        topologyDelta.removeMolecule( reactant.getID() );    
     }
     for( auto& product: candidate.getProducts() )
     {
         product.setID( ++highestMolID );
-        auto molecule __attribute__((unused)) = topologyNew.addMolecule( product );
-        topologyNew.addReactionRecord( highestMolID );
-        // topologyNew.repairMoleculePBC( *molecule );
-        rsmdDEBUG( "new molecule " << molecule->getName() << " got ID " << molecule->getID() );
+        const auto& molecule __attribute__((unused)) = topologyDelta.addMolecule( product );
+        rsmdDEBUG( "new molecule " << molecule.getName() << " got ID " << molecule.getID() );
     }
 }
 
 
 //
-// search for reaction candidates
+// react a given candidate
+// (checks for whether the molecules are still available need to happen before!)
+//
+void Universe::react(ReactionCandidate& candidate)
+{
+    prepareReaction(candidate);
+    auto highestMolID = topologyDelta.getHighestMoleculeID();
+    recordReaction(candidate, highestMolID);
+}
+
+
+//
+// add a candidate to the reaction batch
+// (checks for whether the molecules are still available need to happen before!)
+//
+void Universe::addReaction(const CandidateHandle& candidate)
+{
+    batchCandidates.push_back( candidate );
+    reactionCandidates.markConflicts( candidate, reactantCounts[candidate.reaction] );
+}
+
+
+//
+// react all candidates of the reaction batch
+// (products get consecutive IDs in the order in which the candidates were added)
+//
+const std::vector<ReactionCandidate>& Universe::commitReactions()
+{
+    batchReacted.clear();
+    batchReacted.reserve( batchCandidates.size() );
+    std::size_t nProducts {0};
+    for( const auto& handle: batchCandidates )
+    {
+        batchReacted.push_back( getReactionCandidate(handle) );
+        prepareReaction( batchReacted.back() );
+        nProducts += batchReacted.back().getProducts().size();
+    }
+
+    topologyDelta.reserve( nProducts );
+    auto highestMolID = topologyDelta.getHighestMoleculeID();
+    for( auto& candidate: batchReacted )
+    {
+        recordReaction( candidate, highestMolID );
+    }
+
+    batchCandidates.clear();
+    return batchReacted;
+}
+
+
+//
+// collect molecules that might react as reactant k of reaction template t
+// (given the already chosen molecules for the earlier reactants):
+// for linked reactants, only molecules within the cutoff of the anchor atom (from the neighbour list),
+// else all molecules of the correct type
+// (sorted, in order to preserve the order in which candidates are created)
+//
+void Universe::findPartners(const std::size_t& t, const std::size_t& k, const std::vector<std::size_t>& chosen, std::vector<std::size_t>& partners, SearchBuffers& buffers) const
+{
+    partners.clear();
+    const auto& molecules = reactantMolecules[t][k];
+    const auto& link = reactantLinks[t][k];
+    const auto& coordinates = topologyOld.getCoordinates();
+    if( ! link.linked )
+    {
+        partners.resize( molecules.size() );
+        std::iota( partners.begin(), partners.end(), 0 );
+        return;
+    }
+
+    // gather positions of the linked atoms of all neighbours
+    buffers.positions.clear();
+    neighbourLists[t][k].forEachNeighbour( chosen[link.anchor], [&](std::size_t ix)
+    {
+        partners.emplace_back( ix );
+        buffers.positions.push_back( coordinates.getPosition(coordinates.getOffset(molecules[ix]) + link.atom) );
+    });
+
+    // note: compare squared distances against a slightly enlarged cutoff,
+    // the exact check is done when the criterions are evaluated
+    const auto anchorPosition = coordinates.getPosition( coordinates.getOffset(reactantMolecules[t][link.anchor][chosen[link.anchor]]) + link.anchorAtom );
+    const double cutoffSquared = static_cast<double>(link.cutoff) * link.cutoff * (1 + 1e-5);
+    buffers.distancesSquared.resize( partners.size() );
+    enhance::batchDistancesSquared( anchorPosition, buffers.positions, 0, partners.size(), topologyOld.getDimensions(), buffers.distancesSquared.data() );
+
+    std::size_t nPartners {0};
+    for( std::size_t i=0; i<partners.size(); ++i )
+    {
+        if( buffers.distancesSquared[i] <= cutoffSquared )  partners[nPartners++] = partners[i];
+    }
+    partners.resize( nPartners );
+    std::sort( partners.begin(), partners.end() );
+}
+
+
+//
+// check the criterions of reaction template t that become decidable with reactant k,
+// for the chosen molecules of the earlier reactants and the molecule of reactant k 
+// taken from each of the given molecules
+// (evaluates the stage k of the compiled criterion program for all of them at once, directly on the molecules in topologyOld)
+//
+void Universe::checkCriterions(const std::size_t& t, const std::size_t& k, const std::vector<std::size_t>& indices, SearchBuffers& buffers) const
+{
+    const auto& coordinates = topologyOld.getCoordinates();
+    buffers.batchOffsets.clear();
+    for( auto ix: indices )     buffers.batchOffsets.push_back( coordinates.getOffset(reactantMolecules[t][k][ix]) );
+    buffers.chosenOffsets.resize( k );
+    criterionPrograms[t].runBatch( coordinates, buffers.chosenOffsets, k, buffers.batchOffsets, topologyOld.getDimensions(), buffers.criterionBatch );
+}
+
+
+//
+// enumerate reaction candidates of reaction template t by backtracking over the reactants:
+// the molecules in buffers.partners[k] are checked at once as reactant k against all criterions
+// whose atoms are bound by then, and for each one that passes the possible molecules 
+// of the next reactant are collected (or a candidate is added, if k is the last reactant)
+//
+// duplicates are skipped: a molecule is only used once per candidate, and 
+// consecutive reactants with the same name are chosen in order of their molecule IDs
 //
-std::vector<ReactionCandidate> Universe::searchReactionCandidates()
+void Universe::searchCandidates(const std::size_t& t, const std::size_t& k, CandidateList& candidates, SearchBuffers& buffers) const
 {
-    // search for possible reaction candidates and return them if they match all criteria
-    std::vector<ReactionCandidate> reactionCandidates {};
+    const auto& reactants = reactionTemplates[t].getReactants();
+    const auto& molecules = reactantMolecules[t];
+    const auto& program = criterionPrograms[t];
+    const auto& coordinates = topologyOld.getCoordinates();
+    if( buffers.partners[k].empty() )   return;
+
+    // check all molecules of reactant k at once, 
+    // and keep the ones that passed (the buffers of the batch are reused by the next reactant)
+    checkCriterions( t, k, buffers.partners[k], buffers );
+    const auto& result = buffers.criterionBatch;
+    const bool hasFirstValue = ( program.size() > 0 && program.getStage(0) == k );
+    auto& survivors = buffers.survivors[k];
+    auto& firstValues = buffers.firstValues[k];
+    survivors.clear();
+    firstValues.clear();
+    for( auto i: result.alive )
+    {
+        survivors.emplace_back( buffers.partners[k][i] );
+        firstValues.emplace_back( result.firstValues[i] );
+    }
 
-    for( auto& reactionTemplate: reactionTemplates )
+    const bool last = ( k + 1 == reactants.size() );
+    const bool sameName = ( ! last && reactants[k].getName() == reactants[k+1].getName() );
+    for( std::size_t s=0; s<survivors.size(); ++s )
     {
-        if( reactionTemplate.getReactants().size() == 1 )
+        buffers.chosen[k] = survivors[s];
+        buffers.chosenOffsets.resize( k + 1 );
+        buffers.chosenOffsets[k] = coordinates.getOffset( molecules[k][survivors[s]] );
+        if( hasFirstValue )     buffers.firstValue = firstValues[s];
+
+        if( last )
         {
-            for( auto& reactant: topologyOld.getMolecules( reactionTemplate.getReactants()[0].getName() ) )
+            if( buffers.sampling )
             {
-                rsmdDEBUG( "checking reaction candidate: " << reactant.get().getName() << ", " << reactant.get().getID() );
-                reactionCandidates.push_back( reactionTemplate );
-                reactionCandidates.back().updateReactant( 0, reactant.get() );
-                if( ! reactionCandidates.back().valid(topologyOld.getDimensions()) ) reactionCandidates.pop_back();
+                ++ buffers.nCandidates;
+                if( std::uniform_int_distribution<std::size_t>(0, buffers.nCandidates - 1)(buffers.engine) != 0 )  continue;
+                candidates.clear();
             }
-        }
-        else if( reactionTemplate.getReactants().size() == 2 )
-        {
-            for( auto& reactant1: topologyOld.getMolecules( reactionTemplate.getReactants()[0].getName() ) )
+            buffers.slots.clear();
+            for( std::size_t r=0; r<reactants.size(); ++r )
             {
-                for( auto& reactant2: topologyOld.getMolecules( reactionTemplate.getReactants()[1].getName() ) )
-                {
-                    if( reactant1.get() == reactant2.get() ) continue;
-                    if( reactant1.get().getName() == reactant2.get().getName() && reactant1.get().getID() > reactant2.get().getID() ) continue;
-                    rsmdDEBUG( "checking reaction candidate: " << reactant1.get().getName() << ", " << reactant1.get().getID() << " + " << reactant2.get().getName() << ", " << reactant2.get().getID() );
-                    reactionCandidates.push_back( reactionTemplate );
-                    reactionCandidates.back().updateReactant( 0, reactant1.get() );
-                    reactionCandidates.back().updateReactant( 1, reactant2.get() );
-                    if( ! reactionCandidates.back().valid(topologyOld.getDimensions()) )   reactionCandidates.pop_back();
-
-                }
+                buffers.slots.emplace_back( molecules[r][buffers.chosen[r]] );
+                rsmdDEBUG( "valid reaction candidate, reactant " << r + 1 << ": " << reactants[r].getName() << ", " << coordinates.getMoleculeID(buffers.chosenOffsets[r]) );
             }
+            candidates.addCandidate( t, buffers.slots, buffers.firstValue );
+            continue;
         }
-        else if( reactionTemplate.getReactants().size() == 3 )
+
+        // collect molecules of the next reactant
+        auto& partners = buffers.partners[k+1];
+        findPartners( t, k + 1, buffers.chosen, partners, buffers );
+        const auto chosenID = coordinates.getMoleculeID( buffers.chosenOffsets[k] );
+        std::size_t nPartners {0};
+        for( auto ix: partners )
         {
-            for( auto& reactant1: topologyOld.getMolecules( reactionTemplate.getReactants()[0].getName() ) )
-            {
-                for( auto& reactant2: topologyOld.getMolecules( reactionTemplate.getReactants()[1].getName() ) )
-                {
-                    if( reactant1.get() == reactant2.get() ) continue;
-                    if( reactant1.get().getName() == reactant2.get().getName() && reactant1.get().getID() > reactant2.get().getID() ) continue; 
-                    for( auto& reactant3: topologyOld.getMolecules( reactionTemplate.getReactants()[2].getName() ) )
-                    {
-                        if( reactant1.get() == reactant3.get() || reactant2.get() == reactant3.get() )  continue;
-                        if( reactant2.get().getName() == reactant3.get().getName() && reactant2.get().getID() > reactant3.get().getID() ) continue;
-                        rsmdDEBUG( "checking reaction candidate: " << reactant1.get().getName() << ", " << reactant1.get().getID() 
-                                                          << " + " << reactant2.get().getName() << ", " << reactant2.get().getID() 
-                                                          << " + " << reactant3.get().getName() << ", " << reactant3.get().getID() );
-                        reactionCandidates.push_back( reactionTemplate );
-                        reactionCandidates.back().updateReactant( 0, reactant1.get() );
-                        reactionCandidates.back().updateReactant( 1, reactant2.get() );
-                        reactionCandidates.back().updateReactant( 2, reactant3.get() );
-                        if( ! reactionCandidates.back().valid(topologyOld.getDimensions()) )   reactionCandidates.pop_back();
-                    }
-                }
-            }
+            const auto partner = coordinates.getOffset( molecules[k+1][ix] );
+            if( std::find(buffers.chosenOffsets.begin(), buffers.chosenOffsets.end(), partner) != buffers.chosenOffsets.end() )   continue;
+            if( sameName && chosenID > coordinates.getMoleculeID(partner) ) continue;
+            partners[nPartners++] = ix;
         }
-        else
+        partners.resize( nPartners );
+        searchCandidates( t, k + 1, candidates, buffers );
+    }
+}
+
+
+//
+// search for reaction candidates of reaction template t, for which the first reactant 
+// is one of the molecules [first, last) in reactantMolecules, and add them to the given list
+// (only uses local state, so it can be called concurrently for different ranges)
+//
+void Universe::searchCandidateRange(const std::size_t& t, const std::size_t& first, const std::size_t& last, CandidateList& candidates, SearchBuffers& buffers) const
+{
+    const auto nReactants = reactionTemplates[t].getReactants().size();
+    buffers.chosen.assign( nReactants, 0 );
+    buffers.chosenOffsets.clear();
+    buffers.firstValue = 0;
+    buffers.nCandidates = 0;
+    if( buffers.partners.size() < nReactants )
+    {
+        buffers.partners.resize( nReactants );
+        buffers.survivors.resize( nReactants );
+        buffers.firstValues.resize( nReactants );
+    }
+
+    auto& partners = buffers.partners[0];
+    partners.resize( last - first );
+    std::iota( partners.begin(), partners.end(), first );
+    searchCandidates( t, 0, candidates, buffers );
+}
+
+
+//
+// log the recorded pass rates and the current evaluation order of the criterions
+// (of one / all reaction templates)
+//
+void Universe::logCriterionStatistics(const std::size_t& t) const
+{
+    const auto& program = criterionPrograms[t];
+    const auto& criterions = reactionTemplates[t].getCriterions();
+    for( std::size_t position=0; position<program.getOrder().size(); ++position )
+    {
+        const auto c = program.getOrder()[position];
+        rsmdLOG( "    " << position + 1 << ". criterion " << c + 1 << " (" << criterions[c]->getType() << ", "
+                 << criterions[c]->getMin() << " - " << criterions[c]->getMax() << "): passed " 
+                 << program.getNPassed()[c] << " of " << program.getNTested()[c] << " tests" );
+    }
+}
+
+void Universe::logCriterionStatistics() const
+{
+    for( std::size_t t=0; t<criterionPrograms.size(); ++t )
+    {
+        rsmdLOG( "criterions of reaction " << reactionTemplates[t].getName() << " in order of evaluation:" );
+        logCriterionStatistics( t );
+    }
+}
+
+
+//
+// run the candidate search for all reaction templates
+//
+// the search is split into tasks (per reaction template and chunk of a fixed number of the first reactant's molecules)
+// which are distributed over nThreads threads, each task writes into its own buffer, so that the 
+// buffers can be merged in task order and the result does not depend on the number of threads
+// (when sampling, each task draws from its own random engine, seeded in task order,
+//  so the tasks themselves must not depend on the number of threads either)
+//
+void Universe::runSearchTasks(const bool& sampling)
+{
+    // setup tasks
+    searchTasks.clear();
+    for( std::size_t t=0; t<reactionTemplates.size(); ++t )
+    {
+        const auto nMolecules = reactantMolecules[t][0].size();
+        for( std::size_t first=0; first<nMolecules; first+=moleculesPerSearchTask )
         {
-            rsmdCRITICAL("attention: more than 3 reactants per reaction is currently not implemented!");
+            searchTasks.push_back( SearchTask{ t, first, std::min(first + moleculesPerSearchTask, nMolecules) } );
         }
-        
+    }
+    if( candidateBuffers.size() < searchTasks.size() )    candidateBuffers.resize( searchTasks.size() );
+    if( searchBuffers.size() < searchTasks.size() )       searchBuffers.resize( searchTasks.size() );
+    for( auto& buffer: candidateBuffers )   buffer.clear();
+    for( std::size_t i=0; i<searchTasks.size(); ++i )
+    {
+        searchBuffers[i].sampling = sampling;
+        if( sampling )  searchBuffers[i].engine.seed( enhance::RandomEngine.pseudo_engine() );
+    }
+
+    // search for possible reaction candidates and save them if they match all criteria
+    std::atomic<std::size_t> nextTask {0};
+    auto worker = [&]()
+    {
+        for( auto i = nextTask++; i < searchTasks.size(); i = nextTask++ )
+        {
+            searchCandidateRange( searchTasks[i].reaction, searchTasks[i].first, searchTasks[i].last, candidateBuffers[i], searchBuffers[i] );
+        }
+    };
+    const auto nWorkers = std::min( nThreads, searchTasks.size() );
+    if( nWorkers > 1 )
+    {
+        std::vector<std::thread> threads {};
+        for( std::size_t i=1; i<nWorkers; ++i )  threads.emplace_back( worker );
+        worker();
+        for( auto& thread: threads )    thread.join();
+    }
+    else
+    {
+        worker();
+    }
+
+    // collect criterion statistics and adapt the evaluation order of the criterions for the next search
+    for( std::size_t i=0; i<searchTasks.size(); ++i )
+    {
+        criterionPrograms[searchTasks[i].reaction].record( searchBuffers[i].criterionBatch );
+    }
+    for( std::size_t t=0; t<criterionPrograms.size(); ++t )
+    {
+        if( criterionPrograms[t].reorder() )
+        {
+            rsmdLOG( "... changed evaluation order of criterions for reaction " << reactionTemplates[t].getName() << ":" );
+            logCriterionStatistics( t );
+        }
+    }
+}
+
+
+//
+// search for reaction candidates
+// (candidates are stored as lightweight handles in reactionCandidates, 
+//  full ReactionCandidate objects are only created for candidates that are reacted)
+//
+const CandidateList& Universe::searchReactionCandidates()
+{
+    runSearchTasks( false );
+
+    // merge buffers in task order
+    reactionCandidates.clear();
+    candidateCounts.assign( reactionTemplates.size(), 0 );
+    for( std::size_t i=0; i<searchTasks.size(); ++i )
+    {
+        reactionCandidates.append( candidateBuffers[i] );
+        candidateCounts[searchTasks[i].reaction] += candidateBuffers[i].size();
     }
 
     // shuffle candidates
     enhance::shuffle(reactionCandidates.begin(), reactionCandidates.end());
+    reactionCandidates.buildConflictIndex( reactantCounts, topologyOld.size() );
 
     return reactionCandidates;
 }
 
+
+//
+// search for reaction candidates without storing them:
+// valid candidates are counted per reaction template and each task keeps one of its candidates,
+// the samples of the tasks of a reaction template are merged with probabilities according 
+// to their counts, such that the remaining candidate is chosen uniformly among all candidates 
+// of the reaction template
+// (reactionCandidates then contains one candidate per reaction template with valid candidates)
+//
+const CandidateList& Universe::sampleReactionCandidates()
+{
+    runSearchTasks( true );
+
+    std::vector<std::size_t> samples ( reactionTemplates.size(), searchTasks.size() );
+    candidateCounts.assign( reactionTemplates.size(), 0 );
+    for( std::size_t i=0; i<searchTasks.size(); ++i )
+    {
+        const auto& t = searchTasks[i].reaction;
+        const auto& n = searchBuffers[i].nCandidates;
+        if( n == 0 )    continue;
+        candidateCounts[t] += n;
+        if( enhance::random<std::size_t>(1, candidateCounts[t]) <= n )  samples[t] = i;
+    }
+
+    reactionCandidates.clear();
+    for( std::size_t t=0; t<reactionTemplates.size(); ++t )
+    {
+        if( samples[t] < searchTasks.size() )   reactionCandidates.append( candidateBuffers[samples[t]] );
+    }
+    reactionCandidates.buildConflictIndex( reactantCounts, topologyOld.size() );
+    return reactionCandidates;
+}
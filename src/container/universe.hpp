@@ -13,11 +13,20 @@
 
 #include "unitSystem.hpp"
 #include "enhance/random.hpp"
+#include "enhance/cycleArena.hpp"
 #include "container/topology.hpp"
+#include "container/topologyDelta.hpp"
+#include "container/neighbourList.hpp"
 #include "reaction/reactionCandidate.hpp"
+#include "reaction/candidateList.hpp"
+#include "reaction/criterionProgram.hpp"
 #include "parser/topologyParserGMX.hpp"
 #include "parser/reactionParser.hpp"
 
+#include <thread>
+#include <atomic>
+#include <unordered_map>
+
 //
 // universe class
 //
@@ -31,22 +40,177 @@
 class Universe
 {
   private:  
-    // topology related stuff
-    Topology topologyOld {};
-    Topology topologyNew {};
-    Topology topologyRelaxed {};
+    // topology related stuff:
+    // reactions are recorded as changes to topologyOld (topologyDelta), which are only 
+    // turned into the new topology when it is written (topologyNew),
+    // the relaxed configuration is only read when needed, and only for the products (topologyRelaxed)
+    // molecules of topologyOld are allocated from an arena that is reset whenever it is read again,
+    // the ones of the other topologies from an arena that is reset at every update
+    enhance::CycleArena topologyArena {};
+    enhance::CycleArena cycleArena {};
+    Topology topologyOld {&topologyArena};
+    TopologyDelta topologyDelta {};
+    Topology topologyNew {&cycleArena};
+    Topology topologyRelaxed {&cycleArena};
+    std::size_t relaxedCycle {0};
+    bool        relaxedRead {false};
     std::unique_ptr<TopologyParserBase> topologyParser {nullptr};
 
+    // cycle from which topologyOld was read, and whether it may be kept for the next update
+    // of the same cycle (i.e. after a rejected reactive step), in which case only positions are refreshed
+    std::size_t topologyCycle {0};
+    bool        topologyRead  {false};
+    bool        reuseTopology {false};
+
     // reaction related stuff
     std::vector<ReactionBase> reactionTemplates {};
-    
+
     std::unique_ptr<UnitSystem> unitSystem {nullptr};
 
+    // candidate search related stuff:
+    // a reactant is linked to an earlier reactant of the same reaction template
+    // if a distance criterion connects both, in which case only molecules
+    // within the cutoff (found via a neighbour list) need to be considered
+    struct ReactantLink
+    {
+        bool        linked     {false};
+        std::size_t anchor     {0};     // index of the earlier reactant
+        std::size_t anchorAtom {0};     // atom index within the anchor molecule
+        std::size_t atom       {0};     // atom index within this reactant molecule
+        REAL        cutoff     {0};
+    };
+    std::vector<std::vector<ReactantLink>> reactantLinks {};    // per reaction template and reactant
+    std::vector<std::vector<std::vector<std::size_t>>> reactantMolecules {};   // per reaction template and reactant (indices in topologyOld)
+
+    // neighbour lists for linked reactants are built with a cutoff of (link cutoff + skin)
+    // and kept over cycles until one of the tracked atoms moved by more than half of the skin
+    std::vector<std::vector<NeighbourList>> neighbourLists {};                  // per reaction template and reactant
+    std::vector<std::vector<std::vector<std::size_t>>> trackedAtoms {};         // per reaction template and reactant (atom indices within molecule)
+    std::vector<std::vector<std::vector<REALVEC>>> referencePositions {};       // per reaction template and reactant (tracked atoms at last build)
+    std::vector<std::vector<std::vector<std::size_t>>> neighbourListIDs {};     // per reaction template and reactant (molecule IDs)
+    REAL        skin {0};
+    REALVEC     neighbourListBox {0, 0, 0};
+    std::size_t neighbourListCycle {0};
+    bool        neighbourListsBuilt {false};
+
+    // molecule ID changes due to sorting the latest written topology
+    // (molecules with IDs up to sortedUnchanged kept their ID)
+    std::unordered_map<std::size_t, std::size_t> sortedMoleculeIDs {};
+    std::size_t sortedUnchanged {0};
+    std::size_t sortedCycle {0};
+    bool        sortedMoleculeIDsValid {false};
+
+    // compiled criterions
+    std::vector<CriterionProgram> criterionPrograms {};     // per reaction template
+
+    // buffers of the candidate search (one per search task, reused to avoid allocations)
+    // + state of the enumeration, i.e. the chosen molecules of the reactants so far
+    //   and per reactant the molecules to check and the ones that passed the check
+    struct SearchBuffers
+    {
+        enhance::CoordinateBlock positions {};
+        std::vector<float> distancesSquared {};
+        std::vector<std::size_t> batchOffsets {};
+        CriterionBatch criterionBatch {};
+
+        std::vector<std::size_t> chosen {};
+        std::vector<std::size_t> chosenOffsets {};
+        std::vector<std::uint32_t> slots {};
+        std::vector<std::vector<std::size_t>> partners {};
+        std::vector<std::vector<std::size_t>> survivors {};
+        std::vector<std::vector<REAL>> firstValues {};
+        REAL firstValue {0};
+
+        // when sampling, valid candidates are only counted and one of them is kept (reservoir sampling)
+        bool sampling {false};
+        std::size_t nCandidates {0};
+        std::mt19937_64 engine {};
+    };
+
+    // a search task, i.e. a reaction template and a range of molecules of its first reactant
+    // (of a fixed size, such that the tasks don't depend on the number of threads)
+    struct SearchTask
+    {
+        std::size_t reaction {0};
+        std::size_t first {0};
+        std::size_t last {0};
+    };
+    static constexpr std::size_t moleculesPerSearchTask {64};
+
+    // reaction candidates found in the latest search
+    // (+ buffers per search task, and number of threads used for the search)
+    // (+ number of valid candidates per reaction template, in case they were sampled)
+    CandidateList reactionCandidates {};
+    std::vector<std::size_t> candidateCounts {};
+    std::vector<SearchTask> searchTasks {};
+    std::vector<CandidateList> candidateBuffers {};
+    std::vector<SearchBuffers> searchBuffers {};
+    std::size_t nThreads {1};
+
+    // reaction batch: accepted candidates that are reacted together
+    // (+ the reacted candidates of the latest commit)
+    // (+ number of reactants per reaction template, for the conflict index of the candidates)
+    std::vector<CandidateHandle> batchCandidates {};
+    std::vector<ReactionCandidate> batchReacted {};
+    std::vector<std::size_t> reactantCounts {};
+
+    //
+    // setup links between reactants / update neighbour lists for the candidate search
+    //
+    void setupReactantLinks();
+    void updateNeighbourLists(const std::size_t&);
+    void buildNeighbourLists(const std::size_t&);
+    bool remapNeighbourLists(const std::size_t&);
+    REAL maxDisplacement(const std::size_t&) const;
+
+    //
+    // check the criterions of a reaction template that become decidable with the given reactant 
+    // (on the coordinate store of topologyOld), for the chosen molecules of the earlier reactants in buffers.chosenOffsets 
+    // and the molecule of the reactant taken from each of the given molecules (indices in reactantMolecules),
+    // returns the valid ones and the values of their first (distance) criterion in buffers.criterionBatch
+    //
+    void checkCriterions(const std::size_t&, const std::size_t&, const std::vector<std::size_t>&, SearchBuffers&) const;
+
+    //
+    // collect molecules (indices in reactantMolecules) that might react as reactant
+    // of a reaction template, given the already chosen molecules for the earlier reactants
+    //
+    void findPartners(const std::size_t&, const std::size_t&, const std::vector<std::size_t>&, std::vector<std::size_t>&, SearchBuffers&) const;
+
+    //
+    // enumerate reaction candidates of a reaction template from the given reactant on,
+    // for the molecules in buffers.partners of that reactant
+    //
+    void searchCandidates(const std::size_t&, const std::size_t&, CandidateList&, SearchBuffers&) const;
+
+    //
+    // search for reaction candidates of a reaction template for a range of molecules of the first reactant
+    //
+    void searchCandidateRange(const std::size_t&, const std::size_t&, const std::size_t&, CandidateList&, SearchBuffers&) const;
+
+    //
+    // run the candidate search for all reaction templates in parallel tasks
+    // (either collecting all valid candidates or sampling one per task)
+    //
+    void runSearchTasks(const bool&);
+
+    //
+    // log the recorded pass rates and the evaluation order of the criterions of a reaction template
+    //
+    void logCriterionStatistics(const std::size_t&) const;
+
     //
     // repair a molecule in case it is broken across periodic boundaries
     //
     void makeMoleculeWhole(Molecule&, const REALVEC& dimensions);
 
+    //
+    // create the products of a candidate / record the reaction of a candidate
+    // (products get consecutive IDs after the given highest molecule ID, which is updated)
+    //
+    void prepareReaction(ReactionCandidate&);
+    void recordReaction(ReactionCandidate&, std::size_t&);
+
   public:
     //
     // initial setup of the universe
@@ -71,18 +235,44 @@ class Universe
     //
     // search for reaction candidates
     //
-    std::vector<ReactionCandidate> searchReactionCandidates();
+    const CandidateList& searchReactionCandidates();
+
+    //
+    // search for reaction candidates, but only count the valid candidates per reaction template
+    // and keep one of them (chosen uniformly) per reaction template
+    //
+    const CandidateList& sampleReactionCandidates();
+
+    //
+    // log the recorded pass rates and the current evaluation order of the criterions
+    //
+    void logCriterionStatistics() const;
+
+    //
+    // create the full reaction candidate for a candidate handle
+    //
+    ReactionCandidate getReactionCandidate(const CandidateHandle&) const;
 
     //
     // check availability of given candidate
+    // (i.e. none of its molecules is a reactant of a candidate in the reaction batch)
     //
-    bool isAvailable(const ReactionCandidate&);
+    bool isAvailable(const CandidateHandle&);
 
     //
     // react a given candidate
     //
     void react(ReactionCandidate&);
 
+    //
+    // react several candidates at once:
+    // accepted candidates are added to a batch (their reactants are no longer available from then on),
+    // and all of them are reacted together on commit, which returns the reacted candidates
+    // (a batch that is not committed is discarded with the next update)
+    //
+    void addReaction(const CandidateHandle&);
+    const std::vector<ReactionCandidate>& commitReactions();
+
     //
     // check a given candidate for for 'physical meaningfulness'
     //
@@ -92,5 +282,7 @@ class Universe
     // some getters
     //
     const auto& getReactionTemplates() const { return reactionTemplates; }
+    const auto& getReactionTemplate(const CandidateHandle& candidate) const { return reactionTemplates[candidate.reaction]; }
+    const auto& getCandidateCounts() const { return candidateCounts; }
     
 };
\ No newline at end of file
@@ -182,6 +182,9 @@ void SimulatorBase::writeRestartFile(const Parameters& parameters) const
         FILE << "computeSolvationPotentialEnergy = " << (parameters.getOption("reaction.computeSolvationPotentialEnergy").as<bool>() ? "on" : "off" ) << '\n';
     }
     FILE << "saveRejected = " << (parameters.getOption("reaction.saveRejected").as<bool>() ? "on" : "off") << '\n';
+    FILE << "threads     = " << parameters.getOption("reaction.threads").as<std::size_t>() << '\n';
+    FILE << "skin        = " << parameters.getOption("reaction.skin").as<REAL>() << '\n';
+    FILE << "reuseTopology = " << (parameters.getOption("reaction.reuseTopology").as<bool>() ? "on" : "off") << '\n';
     FILE << '\n';
 
     // md engine related --> [gromacs], ...
@@ -196,6 +199,7 @@ void SimulatorBase::writeRestartFile(const Parameters& parameters) const
             if( parameters.getOption("reaction.computeSolvationPotentialEnergy").as<bool>() )
                 FILE << "mdp.energy   = " << parameters.getOption("gromacs.mdp.energy").as<std::string>() << '\n';
             FILE << "backup       = " << (parameters.getOption("gromacs.backup").as<bool>() ? "on" : "off") << '\n';
+            FILE << "refineCoordinates = " << (parameters.getOption("gromacs.refineCoordinates").as<bool>() ? "on" : "off") << '\n';
             FILE << "nt           = " << parameters.getOption("gromacs.nt").as<int>() << '\n';
             FILE << "ntmpi        = " << parameters.getOption("gromacs.ntmpi").as<int>() << '\n';
             FILE << "ntomp        = " << parameters.getOption("gromacs.ntomp").as<int>() << '\n';
@@ -47,7 +47,7 @@ class SimulatorBase
 
     // some functions that need to be implemented in derived:
     virtual void reactiveStep() = 0;
-    virtual bool acceptance(const ReactionCandidate&) = 0;
+    virtual bool acceptance(const CandidateHandle&) = 0;
 
     // make constructor protected to make the class purely virtual
     SimulatorBase() = default;
@@ -47,25 +47,22 @@ void SimulatorMetropolis::setup(const Parameters& parameters)
 //
 void SimulatorMetropolis::reactiveStep()
 {
-    // search for candidates
+    // search for candidates 
+    // (only the number of candidates per reaction template and one candidate per reaction template are kept)
     universe.update(lastReactiveCycle);
-    auto candidates = universe.searchReactionCandidates(); // returns shuffled vector of reaction candidates
-    STATISTICS_FILE << std::setw(10) << currentCycle << std::setw(15) << candidates.size();
+    const auto& candidates = universe.sampleReactionCandidates();
+    const auto& counts = universe.getCandidateCounts();
+    STATISTICS_FILE << std::setw(10) << currentCycle << std::setw(15) << std::accumulate(counts.begin(), counts.end(), static_cast<std::size_t>(0));
     if( candidates.size() > 0 )
     {
-        // count candidates per reaction type
-        std::map<std::string, int> counts {};
-        for( const auto& rType: universe.getReactionTemplates() )
-        {
-            auto count = std::accumulate(candidates.begin(), candidates.end(), 0, [&rType](int a, auto b){ return a + (b.getName() == rType.getName() ? 1 : 0); });
-            counts[rType.getName()] =  count;
-        }
-        // compute weights
+        // compute weights per reaction template (number of candidates * Boltzmann factor of the activation energy)
         std::vector<REAL> weights {}; 
         std::transform(candidates.begin(), candidates.end(), std::back_inserter(weights),
-                    [&](const auto& c) -> REAL { return std::exp(-1.0 * c.getActivationEnergy() / (temperature*unitSystem->getR())); });
-        // pick a candidate at random (but weighted) and perform reaction
-        auto& candidate = *enhance::random_weighted_choice(candidates.begin(), weights.begin(), weights.end());
+                    [&](const auto& c) -> REAL { return counts[c.reaction] * std::exp(-1.0 * universe.getReactionTemplate(c).getActivationEnergy() / (temperature*unitSystem->getR())); });
+        // pick a reaction template at random (but weighted) and perform reaction for its sampled candidate
+        // (which is equivalent to picking one of all candidates with weights according to their activation energies)
+        const auto& handle = *enhance::random_weighted_choice(candidates.begin(), weights.begin(), weights.end());
+        auto candidate = universe.getReactionCandidate(handle);
         rsmdLOG( "testing reaction candidate ");
         rsmdLOG( candidate.shortInfo() );
         STATISTICS_FILE << std::setw(30) << candidate.getName();
@@ -77,7 +74,7 @@ void SimulatorMetropolis::reactiveStep()
         {
             // check acceptance / reverse if rejected
             mdEngine->runEnergyComputation(currentCycle, lastReactiveCycle);
-            if( acceptance(candidate) )
+            if( acceptance(handle) )
             {
                 lastReactiveCycle = currentCycle;
                 ++ nCyclesAccepted;
@@ -117,14 +114,15 @@ void SimulatorMetropolis::reactiveStep()
 //
 // check acceptance
 //
-bool SimulatorMetropolis::acceptance(const ReactionCandidate& candidate)
+bool SimulatorMetropolis::acceptance(const CandidateHandle& candidate)
 {
     REAL random = enhance::random(0.0, 1.0);
 
+    const auto& reactionEnergy = universe.getReactionTemplate(candidate).getReactionEnergy();
     REAL energyDifference = energyParser->readPotentialEnergyDifference(currentCycle, lastReactiveCycle);
-    rsmdLOG( "... potential energy difference = " << energyDifference << " + " << candidate.getReactionEnergy() 
-                                         << " = " << energyDifference + candidate.getReactionEnergy() << ' ' << unitSystem->energy );
-    energyDifference += candidate.getReactionEnergy();
+    rsmdLOG( "... potential energy difference = " << energyDifference << " + " << reactionEnergy 
+                                         << " = " << energyDifference + reactionEnergy << ' ' << unitSystem->energy );
+    energyDifference += reactionEnergy;
     
     REAL condition = std::exp( -1.0 * energyDifference / (unitSystem->getR() * temperature) );
 
@@ -160,6 +158,7 @@ void SimulatorMetropolis::finish()
     {
         rsmdLOG( "      " << element.second << " " << element.first );
     }
+    universe.logCriterionStatistics();
     rsmdLOG( "" << std::flush );
 }
 
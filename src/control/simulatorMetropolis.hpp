@@ -33,7 +33,7 @@ class SimulatorMetropolis : public SimulatorBase
 
     // some functions that need to be implemented in derived:
     void reactiveStep();
-    bool acceptance(const ReactionCandidate&);
+    bool acceptance(const CandidateHandle&);
 
   public:
     SimulatorMetropolis() = default;
@@ -42,39 +42,45 @@ void SimulatorRate::reactiveStep()
 {
     std::size_t nReactionsAttempted {0};
     std::size_t nReactionsAccepted {0};
-    std::vector<ReactionCandidate> acceptedCandidates {};
     std::unordered_map<std::string, int> candidateTypes {};
 
     // search for candidates
     universe.update(lastReactiveCycle);              
-    auto candidates = universe.searchReactionCandidates();  // returns shuffled vector of reaction candidates
+    const auto& candidates = universe.searchReactionCandidates();  // returns shuffled list of reaction candidates
     STATISTICS_FILE << std::setw(10) << currentCycle << std::setw(15) << candidates.size();
     if( candidates.size() > 0 )
     {
         rsmdLOG( "... found " << candidates.size() << " potential reaction candidates" );
-        // go through candidates and react them if accepted
-        for( auto& candidate: candidates )
+        // go through candidates and add them to the reaction batch if accepted
+        // (full reaction candidates are only created for accepted ones, when the batch is reacted)
+        for( const auto& handle: candidates )
         {
-            if( universe.isAvailable(candidate) )
+            const auto& reactionTemplate = universe.getReactionTemplate(handle);
+            if( universe.isAvailable(handle) )
             {
                 ++ nReactionsAttempted;
-                if( acceptance(candidate) )
+                if( acceptance(handle) )
                 {
-                    universe.react(candidate);
-                    acceptedCandidates.push_back(candidate);
+                    universe.addReaction(handle);
                     ++ nReactionsAccepted;
-                    rsmdLOG( "... reacted candidate " << candidate.shortInfo() );
                 }
             }
             else
             {
-                rsmdDEBUG( candidate.shortInfo() << " is no longer available for reaction" );
+                rsmdDEBUG( "candidate " << reactionTemplate.getName() << " is no longer available for reaction" );
             }
-            candidateTypes.try_emplace( candidate.getName(), 0 );
-            candidateTypes[candidate.getName()] += 1;
+            candidateTypes.try_emplace( reactionTemplate.getName(), 0 );
+            candidateTypes[reactionTemplate.getName()] += 1;
         }        
         STATISTICS_FILE << std::setw(15) << nReactionsAccepted << std::setw(15) << nReactionsAttempted;
 
+        // react all accepted candidates at once
+        const auto& acceptedCandidates = universe.commitReactions();
+        for( const auto& candidate: acceptedCandidates )
+        {
+            rsmdLOG( "... reacted candidate " << candidate.shortInfo() );
+        }
+
         // relaxation
         if( nReactionsAccepted > 0 )
         {
@@ -122,12 +128,13 @@ void SimulatorRate::reactiveStep()
 //
 // check acceptance
 //
-bool SimulatorRate::acceptance(const ReactionCandidate& candidate)
+bool SimulatorRate::acceptance(const CandidateHandle& candidate)
 {
     REAL random = enhance::random(0.0, 1.0);
-    REAL condition = rsFrequency * candidate.getCurrentReactionRateValue(); 
-    rsmdDEBUG( "checking acceptance for candidate " << candidate.shortInfo() );
-    rsmdDEBUG( "condition = " << rsFrequency << "*" << candidate.getCurrentReactionRateValue() << "=" << condition);
+    REAL rateValue = universe.getReactionTemplate(candidate).getReactionRateValue(candidate.distance);
+    REAL condition = rsFrequency * rateValue; 
+    rsmdDEBUG( "checking acceptance for candidate " << universe.getReactionTemplate(candidate).getName() << " at distance " << candidate.distance );
+    rsmdDEBUG( "condition = " << rsFrequency << "*" << rateValue << "=" << condition);
     if( random < condition )
     {
         rsmdDEBUG( "candidate accepted: " << random << " < " << condition );
@@ -155,6 +162,7 @@ void SimulatorRate::finish()
     rsmdLOG( "      " << nCyclesReaction << " with reactions" );
     rsmdLOG( "      " << nCyclesNoReaction << " without reaction" );
     rsmdLOG( "      " << nCyclesFailedFirstRelaxation << " failed during the first relaxation attempt" );
+    universe.logCriterionStatistics();
     rsmdLOG( "" << std::flush );
 }
 
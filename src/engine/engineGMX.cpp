@@ -58,7 +58,6 @@ void EngineGMX::setup(const Parameters& parameters)
     // check what to do in cleanup() after rs was rejected:
     saveRejectedFiles = parameters.getOption("reaction.saveRejected").as<bool>();
     rejectedFilekeys = {".top", "-rs.tpr", "-rs.gro", "-rs.log", "-rs.edr", "-rs.cpt", "-rs.xtc", "-rs-mdpout.mdp", ".reactants.ndx", ".products.ndx"};
-    if( parameters.getOption("reaction.mc").as<bool>() )    rejectedFilekeys.emplace_back("-rs.xvg");
 
     // set backup policy
     if( parameters.getOption("gromacs.backup").as<bool>() )
@@ -236,11 +235,11 @@ bool EngineGMX::runRelaxation( const std::size_t& cycle )
 
 
 // energy   in: cycle = X, lastReactiveCycle = Y 
-//          energy -f X-rs.edr -o X-rs.xvg
-//          energy -f Y-md.edr -o Y-md.xvg
+//          energies are read from X-rs.edr and Y-md.edr by the energy parser,
+//          local energies are computed here by reruns of the reactant/product atoms
+//          (-> reactants.edr / products.edr (+ reactants_solvation.edr / products_solvation.edr))
 void EngineGMX::runEnergyComputation( const std::size_t& currentCycle, const std::size_t& lastReactiveCycle )
 {
-    //      energy -f edr.edr -o xvg.xvg
     std::stringstream before, after, cycle, cycleBefore {};
     before << lastReactiveCycle << "-md"; 
     after << currentCycle << "-rs";
@@ -288,12 +287,6 @@ void EngineGMX::runEnergyComputation( const std::size_t& currentCycle, const std
                     mdrunRerun("reactants_solvation", before.str()+".gro", "reactants_solvation");
                     mdrunRerun("products_solvation", after.str()+".gro", "products_solvation");
                 }
-
-                // convert to .xvg files
-                energy( "reactants", before.str() );
-                energy( "products", after.str() );
-                energySolvation( "reactants_solvation", "reactants_solvation" );
-                energySolvation( "products_solvation", "products_solvation" );
             }
             else
             {
@@ -318,17 +311,9 @@ void EngineGMX::runEnergyComputation( const std::size_t& currentCycle, const std
                     mdrunRerun("reactants", "reactants.gro", "reactants");
                     mdrunRerun("products", "products.gro", "products");
                 }
-                // forth: convert to .xvg file
-                energy( "reactants", before.str() );
-                energy( "products", after.str() );
             }
             backupPolicy = backup;
         }
-        else
-        {
-            energy( before.str(), before.str() );
-            energy( after.str(), after.str() );
-        }
     }
     catch(const std::exception& e)
     {
@@ -478,27 +463,6 @@ void EngineGMX::mdrunRerun( const std::string& tpr, const std::string& trj, cons
 }
 
 
-//      energy -f edr.edr -o xvg.xvg
-void EngineGMX::energy( const std::string& edr, const std::string& xvg)
-{
-    std::string pipeIn = "Potential\n";
-    execute( pipeIn, executablePath.c_str(), executablePath.c_str(), "energy", 
-            "-f", (edr + ".edr").c_str(),
-            "-o", (xvg + ".xvg").c_str(), 
-            "-quiet", "-nocopyright", backupPolicy.c_str() );
-    
-}
-void EngineGMX::energySolvation( const std::string& edr, const std::string& xvg)
-{
-    std::string pipeIn = "Coul-SR:xxx-rest\n LJ-SR:xxx-rest\n";
-    execute( pipeIn, executablePath.c_str(), executablePath.c_str(), "energy", 
-            "-f", (edr + ".edr").c_str(),
-            "-o", (xvg + ".xvg").c_str(), 
-            "-quiet", "-nocopyright", backupPolicy.c_str() );
-    
-}
-
-
 //
 // read mdp file and compare with given input, 
 // give warnings if something doesn't match
@@ -56,8 +56,6 @@ class EngineGMX : public EngineBase
     void mdrun( const std::string& );
     void mdrun( const std::string&, const std::string&, const std::string& );
     void mdrunRerun( const std::string&, const std::string&, const std::string& );
-    void energy( const std::string&, const std::string& );
-    void energySolvation( const std::string&, const std::string& );
     void read_mdp( const std::string& );
 
 
@@ -0,0 +1,161 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "enhance/batchGeometry.hpp"
+#include "enhance/math_utility.hpp"
+
+#include <cmath>
+
+
+namespace
+{
+    //
+    // check, whether the kernels for an instruction set are compiled in and supported by the cpu
+    //
+    bool isSupported(const enhance::InstructionSet& instructionSet)
+    {
+        switch( instructionSet )
+        {
+            case enhance::InstructionSet::AVX512:
+                #ifdef RSMD_HAVE_AVX512
+                    return __builtin_cpu_supports("avx512f");
+                #else
+                    return false;
+                #endif
+            case enhance::InstructionSet::AVX2:
+                #ifdef RSMD_HAVE_AVX2
+                    return __builtin_cpu_supports("avx2");
+                #else
+                    return false;
+                #endif
+            case enhance::InstructionSet::SCALAR:
+                return true;
+        }
+        return false;
+    }
+
+    enhance::InstructionSet bestInstructionSet(const enhance::InstructionSet& wanted)
+    {
+        if( wanted == enhance::InstructionSet::AVX512 && isSupported(enhance::InstructionSet::AVX512) )
+            return enhance::InstructionSet::AVX512;
+        if( wanted != enhance::InstructionSet::SCALAR && isSupported(enhance::InstructionSet::AVX2) )
+            return enhance::InstructionSet::AVX2;
+        return enhance::InstructionSet::SCALAR;
+    }
+
+    enhance::BatchKernels kernelsFor(const enhance::InstructionSet& instructionSet)
+    {
+        switch( instructionSet )
+        {
+            case enhance::InstructionSet::AVX512:   return enhance::avx512Kernels();
+            case enhance::InstructionSet::AVX2:     return enhance::avx2Kernels();
+            case enhance::InstructionSet::SCALAR:   return enhance::scalarKernels();
+        }
+        return enhance::scalarKernels();
+    }
+
+    //
+    // currently used kernels (chosen once at startup)
+    //
+    struct Dispatch
+    {
+        enhance::InstructionSet instructionSet {enhance::InstructionSet::SCALAR};
+        enhance::BatchKernels kernels {};
+
+        Dispatch()
+            : instructionSet( bestInstructionSet(enhance::InstructionSet::AVX512) )
+            , kernels( kernelsFor(instructionSet) )
+        {}
+    };
+
+    Dispatch& dispatch()
+    {
+        static Dispatch current {};
+        return current;
+    }
+
+    inline enhance::BatchPoints points(const enhance::CoordinateBlock& block, const std::size_t& offset = 0)
+    {
+        return enhance::BatchPoints{ block.getX() + offset, block.getY() + offset, block.getZ() + offset };
+    }
+}
+
+
+
+std::string enhance::to_string(const InstructionSet& instructionSet)
+{
+    switch( instructionSet )
+    {
+        case InstructionSet::AVX512:    return "AVX-512";
+        case InstructionSet::AVX2:      return "AVX2";
+        case InstructionSet::SCALAR:    return "scalar";
+    }
+    return "unknown";
+}
+
+
+enhance::InstructionSet enhance::getInstructionSet()
+{
+    return dispatch().instructionSet;
+}
+
+
+void enhance::setInstructionSet(const InstructionSet& instructionSet)
+{
+    dispatch().instructionSet = bestInstructionSet(instructionSet);
+    dispatch().kernels = kernelsFor(dispatch().instructionSet);
+}
+
+
+
+//
+// squared distances between the points of two blocks / between a point and all points of a block
+//
+void enhance::batchDistancesSquared(const CoordinateBlock& block1, const CoordinateBlock& block2, const REALVEC& box, float* out)
+{
+    const float boxArray[3] {box[0], box[1], box[2]};
+    dispatch().kernels.distancesSquared( points(block1), points(block2), boxArray, out, block1.size() );
+}
+
+void enhance::batchDistancesSquared(const REALVEC& point, const CoordinateBlock& block, const std::size_t& offset, const std::size_t& n, const REALVEC& box, float* out)
+{
+    const float boxArray[3] {box[0], box[1], box[2]};
+    const float pointArray[3] {point[0], point[1], point[2]};
+    dispatch().kernels.pointDistancesSquared( pointArray, points(block, offset), boxArray, out, n );
+}
+
+
+//
+// cosines of the angles 1 - 2 - 3
+//
+void enhance::batchCosines(const CoordinateBlock& block1, const CoordinateBlock& block2, const CoordinateBlock& block3, const REALVEC& box, float* out)
+{
+    const float boxArray[3] {box[0], box[1], box[2]};
+    dispatch().kernels.cosines( points(block1), points(block2), points(block3), boxArray, out, block1.size() );
+}
+
+
+//
+// dihedral angles 1 - 2 - 3 - 4 in degrees
+// (the kernels compute the arguments of atan2 in the same way as enhance::dihedral,
+//  but with unnormalised normal vectors, which scales both arguments by the same positive factor)
+//
+void enhance::batchDihedrals(const CoordinateBlock& block1, const CoordinateBlock& block2, const CoordinateBlock& block3, const CoordinateBlock& block4, const REALVEC& box, float* out)
+{
+    const float boxArray[3] {box[0], box[1], box[2]};
+    const auto n = block1.size();
+    std::vector<float> ys( n );
+    dispatch().kernels.dihedralArguments( points(block1), points(block2), points(block3), points(block4), boxArray, out, ys.data(), n );
+    for( std::size_t i=0; i<n; ++i )
+    {
+        if( out[i] != undefinedGeometry )   out[i] = enhance::rad2deg( std::atan2(out[i], ys[i]) );
+    }
+}
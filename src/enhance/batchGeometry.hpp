@@ -0,0 +1,97 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "definitions.hpp"
+#include "enhance/batchGeometryKernels.hpp"
+
+#include <vector>
+#include <string>
+
+//
+// batched (pbc-corrected) geometry kernels
+//
+// compute squared distances, cosines of angles and dihedral angles for many
+// tuples of points at once, with points given as structure-of-arrays blocks:
+// point i of each tuple is taken from block i
+//
+// the kernels are implemented for AVX-512, AVX2 and as scalar fallback,
+// the implementation is chosen at runtime according to the cpu
+//
+// undefined results are marked by enhance::undefinedGeometry, which lies outside the range of
+// all results (no NaNs, as the program may be compiled with -ffast-math)
+//
+// note: results may differ from enhance::distance / angle / dihedral in the last bits,
+// and are meant to be used for (pre)checks with some margin
+//
+
+namespace enhance
+{
+    //
+    // structure-of-arrays block of coordinates
+    //
+    class CoordinateBlock
+    {
+        std::vector<float> x {};
+        std::vector<float> y {};
+        std::vector<float> z {};
+
+      public:
+        inline void push_back(const REALVEC& v) { x.push_back(v[0]); y.push_back(v[1]); z.push_back(v[2]); }
+        inline void set(const std::size_t& i, const REALVEC& v) { x[i] = v[0]; y[i] = v[1]; z[i] = v[2]; }
+        inline void clear()                     { x.clear(); y.clear(); z.clear(); }
+        inline void resize(const std::size_t& n) { x.resize(n); y.resize(n); z.resize(n); }
+        inline auto size()  const               { return x.size(); }
+        inline void reserve(const std::size_t& n) { x.reserve(n); y.reserve(n); z.reserve(n); }
+
+        inline REALVEC operator[](const std::size_t& i) const { return REALVEC(x[i], y[i], z[i]); }
+
+        inline const float* getX() const { return x.data(); }
+        inline const float* getY() const { return y.data(); }
+        inline const float* getZ() const { return z.data(); }
+    };
+
+
+    //
+    // instruction sets for which the kernels are implemented
+    //
+    enum class InstructionSet { SCALAR, AVX2, AVX512 };
+
+    std::string to_string(const InstructionSet&);
+
+    //
+    // get/set the instruction set used by the kernels
+    // (set falls back to the best instruction set supported by the cpu)
+    //
+    InstructionSet getInstructionSet();
+    void           setInstructionSet(const InstructionSet&);
+
+
+    //
+    // squared distances between the points of two blocks / between a point and all points of a block
+    // (n results, starting at offset in the blocks)
+    //
+    void batchDistancesSquared(const CoordinateBlock&, const CoordinateBlock&, const REALVEC&, float*);
+    void batchDistancesSquared(const REALVEC&, const CoordinateBlock&, const std::size_t& offset, const std::size_t& n, const REALVEC&, float*);
+
+    //
+    // cosines of the angles 1 - 2 - 3 (cf. enhance::angle),
+    // undefinedGeometry if one of the vectors has zero length
+    //
+    void batchCosines(const CoordinateBlock&, const CoordinateBlock&, const CoordinateBlock&, const REALVEC&, float*);
+
+    //
+    // dihedral angles 1 - 2 - 3 - 4 in degrees (cf. enhance::dihedral),
+    // undefinedGeometry if the dihedral is (close to) undefined, i.e. if three of the points are (almost) collinear
+    //
+    void batchDihedrals(const CoordinateBlock&, const CoordinateBlock&, const CoordinateBlock&, const CoordinateBlock&, const REALVEC&, float*);
+}
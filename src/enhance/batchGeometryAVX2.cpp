@@ -0,0 +1,67 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "enhance/batchGeometryBodies.hpp"
+
+//
+// AVX2 batched geometry kernels
+// (this file is compiled with -mavx2, if supported by the compiler)
+//
+#ifdef __AVX2__
+
+#include <immintrin.h>
+
+namespace
+{
+    struct AVX2Lanes
+    {
+        using reg = __m256;
+        static constexpr std::size_t width = 8;
+        static inline reg  load(const float* p)       { return _mm256_loadu_ps(p); }
+        static inline void store(float* p, reg v)     { _mm256_storeu_ps(p, v); }
+        static inline reg  set1(float v)              { return _mm256_set1_ps(v); }
+        static inline reg  add(reg a, reg b)          { return _mm256_add_ps(a, b); }
+        static inline reg  sub(reg a, reg b)          { return _mm256_sub_ps(a, b); }
+        static inline reg  mul(reg a, reg b)          { return _mm256_mul_ps(a, b); }
+        static inline reg  div(reg a, reg b)          { return _mm256_div_ps(a, b); }
+        static inline reg  sqrt(reg a)                { return _mm256_sqrt_ps(a); }
+
+        // round half away from zero: truncate and add +-1 if the remainder is at least 0.5
+        static inline reg roundAway(reg a)
+        {
+            const reg sign = _mm256_set1_ps(-0.0f);
+            reg truncated = _mm256_round_ps(a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            reg remainder = _mm256_andnot_ps(sign, _mm256_sub_ps(a, truncated));
+            reg step = _mm256_or_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(sign, a));
+            reg mask = _mm256_cmp_ps(remainder, _mm256_set1_ps(0.5f), _CMP_GE_OQ);
+            return _mm256_add_ps(truncated, _mm256_and_ps(mask, step));
+        }
+
+        static inline reg replaceLessEqual(reg lhs, reg rhs, reg v, reg replacement)
+        {
+            return _mm256_blendv_ps(v, replacement, _mm256_cmp_ps(lhs, rhs, _CMP_LE_OQ));
+        }
+    };
+}
+
+enhance::BatchKernels enhance::avx2Kernels()
+{
+    return makeKernels<AVX2Lanes>();
+}
+
+#else
+
+enhance::BatchKernels enhance::avx2Kernels()
+{
+    return scalarKernels();
+}
+
+#endif
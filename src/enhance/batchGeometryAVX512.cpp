@@ -0,0 +1,70 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "enhance/batchGeometryBodies.hpp"
+
+//
+// AVX-512 batched geometry kernels
+// (this file is compiled with -mavx512f, if supported by the compiler)
+//
+#ifdef __AVX512F__
+
+#include <immintrin.h>
+
+namespace
+{
+    struct AVX512Lanes
+    {
+        using reg = __m512;
+        static constexpr std::size_t width = 16;
+        // note: masked intrinsics avoid _mm512_undefined_ps, which triggers false warnings with some compilers
+        static constexpr __mmask16 all = 0xFFFF;
+        static inline reg  load(const float* p)       { return _mm512_loadu_ps(p); }
+        static inline void store(float* p, reg v)     { _mm512_storeu_ps(p, v); }
+        static inline reg  set1(float v)              { return _mm512_set1_ps(v); }
+        static inline reg  add(reg a, reg b)          { return _mm512_add_ps(a, b); }
+        static inline reg  sub(reg a, reg b)          { return _mm512_sub_ps(a, b); }
+        static inline reg  mul(reg a, reg b)          { return _mm512_mul_ps(a, b); }
+        static inline reg  div(reg a, reg b)          { return _mm512_div_ps(a, b); }
+        static inline reg  sqrt(reg a)                { return _mm512_maskz_sqrt_ps(all, a); }
+
+        // round half away from zero: truncate and add +-1 if the remainder is at least 0.5
+        static inline reg roundAway(reg a)
+        {
+            const __m512i sign = _mm512_set1_epi32(static_cast<int>(0x80000000u));
+            reg truncated = _mm512_maskz_roundscale_ps(all, a, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            reg remainder = _mm512_abs_ps(_mm512_sub_ps(a, truncated));
+            reg step = _mm512_castsi512_ps( _mm512_or_si512( _mm512_castps_si512(_mm512_set1_ps(1.0f)), 
+                                                             _mm512_and_si512(sign, _mm512_castps_si512(a)) ) );
+            __mmask16 mask = _mm512_cmp_ps_mask(remainder, _mm512_set1_ps(0.5f), _CMP_GE_OQ);
+            return _mm512_mask_add_ps(truncated, mask, truncated, step);
+        }
+
+        static inline reg replaceLessEqual(reg lhs, reg rhs, reg v, reg replacement)
+        {
+            return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(lhs, rhs, _CMP_LE_OQ), v, replacement);
+        }
+    };
+}
+
+enhance::BatchKernels enhance::avx512Kernels()
+{
+    return makeKernels<AVX512Lanes>();
+}
+
+#else
+
+enhance::BatchKernels enhance::avx512Kernels()
+{
+    return scalarKernels();
+}
+
+#endif
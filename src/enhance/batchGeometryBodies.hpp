@@ -0,0 +1,199 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "enhance/batchGeometryKernels.hpp"
+
+//
+// bodies of the batched geometry kernels
+//
+// only to be included by the translation units that implement the kernels
+// for a specific instruction set (batchGeometry*.cpp):
+// everything is defined in an anonymous namespace and does not use any (inline) 
+// functions of other headers, such that no code for a specific instruction set 
+// can leak into the rest of the program
+//
+// the kernels are templated on the lanes (V) of an instruction set, which provide:
+// reg, width, load, store, set1, add, sub, mul, div, sqrt,
+// roundAway (round half away from zero, as std::round), replaceLessEqual (replacement where lhs <= rhs),
+// the remaining elements are handled with scalar lanes (S)
+//
+
+namespace
+{
+    template<typename V>
+    inline typename V::reg minimumImage(typename V::reg d, typename V::reg box)
+    {
+        return V::sub( d, V::mul(box, V::roundAway(V::div(d, box))) );
+    }
+
+    template<typename V>
+    struct Vectors
+    {
+        typename V::reg x, y, z;
+    };
+
+    template<typename V>
+    inline Vectors<V> distanceVectors(const enhance::BatchPoints& p1, const enhance::BatchPoints& p2, std::size_t i,
+                                      const Vectors<V>& box)
+    {
+        return Vectors<V>{ minimumImage<V>( V::sub(V::load(p2.x + i), V::load(p1.x + i)), box.x ),
+                           minimumImage<V>( V::sub(V::load(p2.y + i), V::load(p1.y + i)), box.y ),
+                           minimumImage<V>( V::sub(V::load(p2.z + i), V::load(p1.z + i)), box.z ) };
+    }
+
+    template<typename V>
+    inline typename V::reg dot(const Vectors<V>& a, const Vectors<V>& b)
+    {
+        return V::add( V::add(V::mul(a.x, b.x), V::mul(a.y, b.y)), V::mul(a.z, b.z) );
+    }
+
+    template<typename V>
+    inline Vectors<V> cross(const Vectors<V>& a, const Vectors<V>& b)
+    {
+        return Vectors<V>{ V::sub(V::mul(a.y, b.z), V::mul(a.z, b.y)),
+                           V::sub(V::mul(a.z, b.x), V::mul(a.x, b.z)),
+                           V::sub(V::mul(a.x, b.y), V::mul(a.y, b.x)) };
+    }
+
+    template<typename V>
+    inline Vectors<V> broadcast(const float* v)
+    {
+        return Vectors<V>{ V::set1(v[0]), V::set1(v[1]), V::set1(v[2]) };
+    }
+
+    template<typename V, typename S>
+    void distancesSquared(enhance::BatchPoints p1, enhance::BatchPoints p2, const float* box, float* out, std::size_t n)
+    {
+        const auto b = broadcast<V>(box);
+        std::size_t i = 0;
+        for( ; i + V::width <= n; i += V::width )
+        {
+            auto d = distanceVectors<V>(p1, p2, i, b);
+            V::store( out + i, dot<V>(d, d) );
+        }
+        const auto s = broadcast<S>(box);
+        for( ; i < n; ++i )
+        {
+            auto d = distanceVectors<S>(p1, p2, i, s);
+            S::store( out + i, dot<S>(d, d) );
+        }
+    }
+
+    template<typename V, typename S>
+    void pointDistancesSquared(const float* point, enhance::BatchPoints p2, const float* box, float* out, std::size_t n)
+    {
+        const auto b = broadcast<V>(box);
+        const auto p = broadcast<V>(point);
+        std::size_t i = 0;
+        for( ; i + V::width <= n; i += V::width )
+        {
+            Vectors<V> d { minimumImage<V>( V::sub(V::load(p2.x + i), p.x), b.x ),
+                           minimumImage<V>( V::sub(V::load(p2.y + i), p.y), b.y ),
+                           minimumImage<V>( V::sub(V::load(p2.z + i), p.z), b.z ) };
+            V::store( out + i, dot<V>(d, d) );
+        }
+        const auto s = broadcast<S>(box);
+        const auto q = broadcast<S>(point);
+        for( ; i < n; ++i )
+        {
+            Vectors<S> d { minimumImage<S>( S::sub(S::load(p2.x + i), q.x), s.x ),
+                           minimumImage<S>( S::sub(S::load(p2.y + i), q.y), s.y ),
+                           minimumImage<S>( S::sub(S::load(p2.z + i), q.z), s.z ) };
+            S::store( out + i, dot<S>(d, d) );
+        }
+    }
+
+    template<typename V>
+    inline void cosine(const enhance::BatchPoints& p1, const enhance::BatchPoints& p2, const enhance::BatchPoints& p3,
+                       std::size_t i, const Vectors<V>& b, float* out)
+    {
+        auto v1 = distanceVectors<V>(p1, p2, i, b);
+        auto v2 = distanceVectors<V>(p2, p3, i, b);
+        auto squaredNorms = V::mul( dot<V>(v1, v1), dot<V>(v2, v2) );
+        auto cosine = V::div( dot<V>(v1, v2), V::sqrt(squaredNorms) );
+        V::store( out + i, V::replaceLessEqual(squaredNorms, V::set1(0.0f), cosine, V::set1(enhance::undefinedGeometry)) );
+    }
+
+    template<typename V, typename S>
+    void cosines(enhance::BatchPoints p1, enhance::BatchPoints p2, enhance::BatchPoints p3,
+                 const float* box, float* out, std::size_t n)
+    {
+        const auto b = broadcast<V>(box);
+        std::size_t i = 0;
+        for( ; i + V::width <= n; i += V::width )   cosine<V>(p1, p2, p3, i, b, out);
+        const auto s = broadcast<S>(box);
+        for( ; i < n; ++i )                         cosine<S>(p1, p2, p3, i, s, out);
+    }
+
+    template<typename V>
+    inline void dihedralArgument(const enhance::BatchPoints& p1, const enhance::BatchPoints& p2,
+                                 const enhance::BatchPoints& p3, const enhance::BatchPoints& p4,
+                                 std::size_t i, const Vectors<V>& b, float* xs, float* ys)
+    {
+        auto v1 = distanceVectors<V>(p1, p2, i, b);
+        auto v2 = distanceVectors<V>(p2, p3, i, b);
+        auto v3 = distanceVectors<V>(p3, p4, i, b);
+        auto m1 = cross<V>(v1, v2);
+        auto m2 = cross<V>(v2, v3);
+        auto v2Squared = dot<V>(v2, v2);
+        auto x = dot<V>( cross<V>(m1, m2), v2 );
+        auto y = V::mul( dot<V>(m1, m2), V::sqrt(v2Squared) );
+        // (almost) collinear points: |m|^2 <= 1e-4 * |a|^2 * |b|^2
+        const auto threshold = V::set1(1e-4f);
+        auto limit1 = V::mul( threshold, V::mul(dot<V>(v1, v1), v2Squared) );
+        auto limit2 = V::mul( threshold, V::mul(v2Squared, dot<V>(v3, v3)) );
+        const auto undefined = V::set1(enhance::undefinedGeometry);
+        x = V::replaceLessEqual( dot<V>(m1, m1), limit1, x, undefined );
+        x = V::replaceLessEqual( dot<V>(m2, m2), limit2, x, undefined );
+        V::store( xs + i, x );
+        V::store( ys + i, y );
+    }
+
+    template<typename V, typename S>
+    void dihedralArguments(enhance::BatchPoints p1, enhance::BatchPoints p2, enhance::BatchPoints p3,
+                           enhance::BatchPoints p4, const float* box, float* xs, float* ys, std::size_t n)
+    {
+        const auto b = broadcast<V>(box);
+        std::size_t i = 0;
+        for( ; i + V::width <= n; i += V::width )   dihedralArgument<V>(p1, p2, p3, p4, i, b, xs, ys);
+        const auto s = broadcast<S>(box);
+        for( ; i < n; ++i )                         dihedralArgument<S>(p1, p2, p3, p4, i, s, xs, ys);
+    }
+
+    struct ScalarLanes
+    {
+        using reg = float;
+        static constexpr std::size_t width = 1;
+        static inline reg  load(const float* p)       { return *p; }
+        static inline void store(float* p, reg v)     { *p = v; }
+        static inline reg  set1(float v)              { return v; }
+        static inline reg  add(reg a, reg b)          { return a + b; }
+        static inline reg  sub(reg a, reg b)          { return a - b; }
+        static inline reg  mul(reg a, reg b)          { return a * b; }
+        static inline reg  div(reg a, reg b)          { return a / b; }
+        static inline reg  sqrt(reg a)                { return __builtin_sqrtf(a); }
+        static inline reg  roundAway(reg a)           { return __builtin_roundf(a); }
+        static inline reg  replaceLessEqual(reg lhs, reg rhs, reg v, reg replacement) { return ( lhs <= rhs ? replacement : v ); }
+    };
+
+    template<typename V>
+    enhance::BatchKernels makeKernels()
+    {
+        enhance::BatchKernels kernels {};
+        kernels.distancesSquared      = &distancesSquared<V, ScalarLanes>;
+        kernels.pointDistancesSquared = &pointDistancesSquared<V, ScalarLanes>;
+        kernels.cosines               = &cosines<V, ScalarLanes>;
+        kernels.dihedralArguments     = &dihedralArguments<V, ScalarLanes>;
+        return kernels;
+    }
+}
@@ -0,0 +1,58 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include <cstddef>
+
+//
+// internal interface of the batched geometry kernels (cf. batchGeometry.hpp)
+//
+// the kernels for each instruction set live in their own translation unit, which is
+// compiled with the corresponding compiler flags (-mavx2, -mavx512f),
+// therefore the interface only uses plain pointers
+// (the kernel bodies are in batchGeometryBodies.hpp)
+//
+
+namespace enhance
+{
+    //
+    // marker for undefined results (cf. batchGeometry.hpp)
+    //
+    constexpr float undefinedGeometry {1e3f};
+
+    //
+    // coordinates of a block of points
+    //
+    struct BatchPoints
+    {
+        const float* x {nullptr};
+        const float* y {nullptr};
+        const float* z {nullptr};
+    };
+
+    //
+    // kernel table for one instruction set
+    // (dihedralArguments returns the arguments of atan2, x is undefinedGeometry for undefined dihedrals)
+    //
+    struct BatchKernels
+    {
+        void (*distancesSquared)(BatchPoints, BatchPoints, const float*, float*, std::size_t);
+        void (*pointDistancesSquared)(const float*, BatchPoints, const float*, float*, std::size_t);
+        void (*cosines)(BatchPoints, BatchPoints, BatchPoints, const float*, float*, std::size_t);
+        void (*dihedralArguments)(BatchPoints, BatchPoints, BatchPoints, BatchPoints, const float*, float*, float*, std::size_t);
+    };
+
+    BatchKernels scalarKernels();
+    BatchKernels avx2Kernels();
+    BatchKernels avx512Kernels();
+}
+
@@ -0,0 +1,20 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "enhance/batchGeometryBodies.hpp"
+
+//
+// scalar batched geometry kernels
+//
+enhance::BatchKernels enhance::scalarKernels()
+{
+    return makeKernels<ScalarLanes>();
+}
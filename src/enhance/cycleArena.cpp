@@ -0,0 +1,73 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "enhance/cycleArena.hpp"
+
+#include <new>
+#include <algorithm>
+
+namespace enhance
+{
+    CycleArena::~CycleArena()
+    {
+        for( const auto& block: blocks )    ::operator delete( block.memory );
+    }
+
+
+    //
+    // add a new block of (at least) the given size
+    //
+    void CycleArena::addBlock(const std::size_t& size)
+    {
+        const auto blockSize = std::max( { size, minBlockSize, ( blocks.empty() ? std::size_t {0} : 2 * blocks.back().size ) } );
+        blocks.push_back( Block{ static_cast<std::byte*>( ::operator new(blockSize) ), blockSize } );
+        used = 0;
+    }
+
+
+    //
+    // allocate from the current block, or from a new one if it is full
+    // (alignments are served up to the alignment of ::operator new)
+    //
+    void* CycleArena::do_allocate(std::size_t bytes, std::size_t alignment)
+    {
+        if( alignment > alignof(std::max_align_t) )     throw std::bad_alloc {};
+
+        auto offset = ( used + alignment - 1 ) / alignment * alignment;
+        if( blocks.empty() || offset + bytes > blocks.back().size )
+        {
+            addBlock( bytes );
+            offset = 0;
+        }
+        void* pointer = blocks.back().memory + offset;
+        totalUsed += offset + bytes - used;
+        used = offset + bytes;
+        return pointer;
+    }
+
+
+    //
+    // release all memory at once
+    // (if more than one block was needed, they are replaced by one block that can hold all of it)
+    //
+    void CycleArena::reset()
+    {
+        if( blocks.size() > 1 )
+        {
+            const auto capacity = getCapacity();
+            for( const auto& block: blocks )    ::operator delete( block.memory );
+            blocks.clear();
+            addBlock( capacity );
+        }
+        used = 0;
+        totalUsed = 0;
+    }
+}
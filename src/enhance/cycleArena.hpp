@@ -0,0 +1,77 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include <memory_resource>
+#include <vector>
+#include <cstddef>
+
+// 
+// memory that lives for one cycle
+//
+
+namespace enhance
+{
+    //
+    // a monotonic memory resource for data that is rebuilt every cycle (e.g. topologies):
+    // allocations are served from large blocks by bumping a pointer, deallocations are ignored
+    // and all memory is released at once by reset()
+    // (the blocks are not returned to the system on reset, but merged into a single block 
+    //  of the size used so far, such that later cycles of the same size don't allocate at all)
+    //
+    // attention: not thread-safe, and everything allocated from the arena has to be 
+    //            released (or rebuilt) before it is reset
+    //
+    class CycleArena
+        : public std::pmr::memory_resource
+    {
+        static constexpr std::size_t minBlockSize {1 << 16};
+
+        struct Block
+        {
+            std::byte*  memory {nullptr};
+            std::size_t size {0};
+        };
+        std::vector<Block> blocks {};
+        std::size_t used {0};           // used bytes in the current (last) block
+        std::size_t totalUsed {0};      // used bytes in all blocks since the last reset
+
+        void addBlock(const std::size_t&);
+
+      protected:
+        void* do_allocate(std::size_t, std::size_t) override;
+        void  do_deallocate(void*, std::size_t, std::size_t) override {}
+        bool  do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+      public:
+        CycleArena() = default;
+        CycleArena(const CycleArena&) = delete;
+        CycleArena& operator=(const CycleArena&) = delete;
+        ~CycleArena() override;
+
+        //
+        // release all memory allocated from the arena at once
+        //
+        void reset();
+
+        //
+        // some getters
+        //
+        inline std::size_t getUsed()     const { return totalUsed; }
+        inline std::size_t getCapacity() const 
+        { 
+            std::size_t capacity {0};
+            for( const auto& block: blocks )    capacity += block.size;
+            return capacity;
+        }
+    };
+}
@@ -0,0 +1,65 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "enhance/mappedFile.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace enhance
+{
+    //
+    // map a file
+    // (an empty file is 'mapped' without memory, the file descriptor is not needed after mapping)
+    //
+    bool MappedFile::open(const std::string& filename)
+    {
+        close();
+        const int fd = ::open( filename.c_str(), O_RDONLY );
+        if( fd < 0 )    return false;
+
+        struct stat status {};
+        if( ::fstat(fd, &status) != 0 )
+        {
+            ::close( fd );
+            return false;
+        }
+
+        length = static_cast<std::size_t>( status.st_size );
+        if( length > 0 )
+        {
+            void* mapped = ::mmap( nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if( mapped == MAP_FAILED )
+            {
+                ::close( fd );
+                length = 0;
+                return false;
+            }
+            ::madvise( mapped, length, MADV_SEQUENTIAL );
+            memory = static_cast<const char*>( mapped );
+        }
+        ::close( fd );
+        return true;
+    }
+
+
+    //
+    // unmap the current file
+    //
+    void MappedFile::close()
+    {
+        if( memory )    ::munmap( const_cast<char*>(memory), length );
+        memory = nullptr;
+        length = 0;
+    }
+}
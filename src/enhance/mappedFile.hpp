@@ -0,0 +1,55 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+// 
+// read-only memory mapped files
+//
+
+namespace enhance
+{
+    //
+    // a file that is mapped into memory (read-only) as a whole,
+    // its content stays valid until the file is closed or another file is opened
+    //
+    class MappedFile
+    {
+        const char* memory {nullptr};
+        std::size_t length {0};
+
+      public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile() { close(); }
+
+        //
+        // map a file, returns false if it can't be opened
+        //
+        bool open(const std::string&);
+
+        //
+        // unmap the current file
+        //
+        void close();
+
+        //
+        // content of the file
+        //
+        inline std::string_view view() const { return std::string_view( memory, length ); }
+        inline std::size_t      size() const { return length; }
+    };
+}
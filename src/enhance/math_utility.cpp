@@ -28,32 +28,11 @@ REALVEC enhance::normalVector(const REALVEC& v1, const REALVEC& v2)
 //
 // calculate (pbc-corrected) distance between two points / two atoms
 //
-REALVEC enhance::distanceVector(const REALVEC& v1, const REALVEC& v2, const REALVEC& box)
-{
-    // outDEBUG( (box.isZero() ? "warning: given pbc dimensions are zero: " : "computing pbc-corrected distance with pbc dimensions ") << box );
-    #ifndef NDEBUG
-        if( box.isZero() )  rsmdDEBUG( "warning: given pbx dimensions are zero" );
-    #endif
-
-    REALVEC distance = v2 - v1;
-    distance(0) = distance(0) - box(0) * std::round( distance(0)/box(0) );
-    distance(1) = distance(1) - box(1) * std::round( distance(1)/box(1) );
-    distance(2) = distance(2) - box(2) * std::round( distance(2)/box(2) );
-
-    return distance;
-}
-
 REALVEC enhance::distanceVector(const Atom& a1, const Atom& a2, const REALVEC& box)
 {
     return distanceVector(a1.position, a2.position, box);
 }
 
-REAL enhance::distance(const REALVEC& v1, const REALVEC& v2, const REALVEC& box)
-{
-    REALVEC distance = enhance::distanceVector(v1, v2, box);
-    return distance.norm();
-}
-
 REAL enhance::distance(const Atom& a1, const Atom& a2, const REALVEC& box)
 {
     return distance(a1.position, a2.position, box);
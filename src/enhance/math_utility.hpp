@@ -54,11 +54,27 @@ namespace enhance
 
     //
     // calculate (pbc-corrected) distance between two points / two atoms
+    // (inline for points, since these are used in the innermost loops of the candidate search)
     //
-    REALVEC distanceVector(const REALVEC& v1, const REALVEC& v2, const REALVEC& box);
+    inline REALVEC distanceVector(const REALVEC& v1, const REALVEC& v2, const REALVEC& box)
+    {
+        #ifndef NDEBUG
+            if( box.isZero() )  rsmdDEBUG( "warning: given pbx dimensions are zero" );
+        #endif
+
+        REALVEC distance = v2 - v1;
+        distance(0) = distance(0) - box(0) * std::round( distance(0)/box(0) );
+        distance(1) = distance(1) - box(1) * std::round( distance(1)/box(1) );
+        distance(2) = distance(2) - box(2) * std::round( distance(2)/box(2) );
+
+        return distance;
+    }
     REALVEC distanceVector(const Atom& a1, const Atom& a2, const REALVEC& box);
 
-    REAL distance(const REALVEC& v1, const REALVEC& v2, const REALVEC& box);
+    inline REAL distance(const REALVEC& v1, const REALVEC& v2, const REALVEC& box)
+    {
+        return distanceVector(v1, v2, box).norm();
+    }
     REAL distance(const Atom& a1, const Atom& a2, const REALVEC& box);
 
 
@@ -27,7 +27,7 @@
 
 namespace enhance
 {
-    static struct RandomEngineInit
+    inline struct RandomEngineInit
     {
         RandomEngineInit();
         auto getSeed()         const { return seed; };
@@ -0,0 +1,61 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "enhance/symbol.hpp"
+
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+
+namespace
+{
+    //
+    // global symbol table
+    // (strings are stored in a deque, such that references to them stay valid)
+    //
+    struct SymbolTable
+    {
+        std::mutex mutex {};
+        std::deque<std::string> strings { std::string {} };
+        std::unordered_map<std::string, std::uint32_t> handles { {std::string {}, 0} };
+    };
+
+    SymbolTable& symbolTable()
+    {
+        static SymbolTable table {};
+        return table;
+    }
+}
+
+
+//
+// get handle of a string, add it to the symbol table if it is new
+//
+std::uint32_t enhance::Symbol::intern(const std::string& s)
+{
+    if( s.empty() ) return 0;
+    auto& table = symbolTable();
+    std::lock_guard<std::mutex> lock( table.mutex );
+    auto inserted = table.handles.emplace( s, static_cast<std::uint32_t>(table.strings.size()) );
+    if( inserted.second )   table.strings.push_back( s );
+    return inserted.first->second;
+}
+
+
+//
+// string of a symbol
+//
+const std::string& enhance::Symbol::str() const
+{
+    auto& table = symbolTable();
+    std::lock_guard<std::mutex> lock( table.mutex );
+    return table.strings[handle];
+}
@@ -0,0 +1,82 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+
+// 
+// interned strings (e.g. atom / molecule names)
+//
+
+namespace enhance
+{
+    //
+    // a symbol is a small handle into a global symbol table, 
+    // that holds each distinct string exactly once:
+    // copies and comparisons for (in)equality are those of an integer,
+    // the string is only needed for input / output 
+    // (handle 0 is the empty string)
+    //
+    class Symbol
+    {
+        std::uint32_t handle {0};
+
+        static std::uint32_t intern(const std::string&);
+
+      public:
+        Symbol() = default;
+        Symbol(const std::string& s) : handle( intern(s) ) {}
+        Symbol(const char* s) : handle( intern(s) ) {}
+
+        //
+        // string of the symbol
+        //
+        const std::string& str() const;
+
+        //
+        // some getters
+        //
+        inline std::uint32_t getHandle() const { return handle; }
+        inline bool          empty()     const { return handle == 0; }
+
+        //
+        // some useful operators
+        // (note: no ordering, as the order of handles is not the order of the strings,
+        //  use str() for lexicographical comparisons)
+        //
+        inline bool operator==(const Symbol& other) const { return handle == other.handle; }
+        inline bool operator!=(const Symbol& other) const { return handle != other.handle; }
+    };
+
+
+    inline std::ostream& operator<<(std::ostream& os, const Symbol& obj)
+    {
+        os << obj.str();
+        return os;
+    }
+}
+
+
+namespace std
+{
+    template<>
+    struct hash<enhance::Symbol>
+    {
+        inline std::size_t operator()(const enhance::Symbol& symbol) const noexcept
+        {
+            return std::hash<std::uint32_t>()( symbol.getHandle() );
+        }
+    };
+}
@@ -135,6 +135,7 @@ namespace enhance
         // some other useful member functions
         //
         float norm() const;
+        float squaredNorm() const;
 
         template<typename O>
         T dot(const Vector3d<O>&) const;
@@ -368,8 +369,13 @@ namespace enhance
     template<typename T>
     float Vector3d<T>::norm() const
     {   
-        float squared = std::inner_product(std::begin(data), std::end(data), std::begin(data), static_cast<float>(0));
-        return std::sqrt(squared); 
+        return std::sqrt(squaredNorm()); 
+    }
+
+    template<typename T>
+    float Vector3d<T>::squaredNorm() const
+    {   
+        return std::inner_product(std::begin(data), std::end(data), std::begin(data), static_cast<float>(0));
     }
 
     template<typename T>
@@ -0,0 +1,111 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+//
+// reading XDR data (as written by gromacs)
+//
+
+namespace enhance
+{
+    //
+    // sequential reader of big-endian (XDR) data in a buffer (e.g. a mapped file),
+    // reading beyond the end of the buffer returns zeros and marks the reader as failed
+    //
+    class XdrReader
+    {
+        std::string_view data;
+        std::size_t position;
+        bool ok;
+
+        inline const unsigned char* take(const std::size_t& n)
+        {
+            if( ! ok || n > data.size() - position )
+            {
+                ok = false;
+                return nullptr;
+            }
+            const auto* bytes = reinterpret_cast<const unsigned char*>( data.data() + position );
+            position += n;
+            return bytes;
+        }
+
+      public:
+        XdrReader(std::string_view d, const std::size_t& p)
+            : data(d), position(std::min(p, d.size())), ok(p <= d.size()) {}
+
+        //
+        // size of opaque data / strings, i.e. padded to multiples of 4 bytes
+        //
+        static inline std::size_t padded(const std::size_t& n)
+        {
+            return ( n + 3 ) & ~std::size_t {3};
+        }
+
+        //
+        // read a single item
+        // (real: float or double, as given)
+        //
+        inline std::uint32_t u32()
+        {
+            const auto* b = take(4);
+            if( ! b )   return 0;
+            return ( std::uint32_t {b[0]} << 24 ) | ( std::uint32_t {b[1]} << 16 ) | ( std::uint32_t {b[2]} << 8 ) | std::uint32_t {b[3]};
+        }
+        inline std::uint64_t u64()
+        {
+            const std::uint64_t high = u32();
+            return ( high << 32 ) | u32();
+        }
+        inline std::int32_t i32() { return static_cast<std::int32_t>( u32() ); }
+        inline std::int64_t i64() { return static_cast<std::int64_t>( u64() ); }
+        inline float f32()
+        {
+            const auto bits = u32();
+            float value;
+            std::memcpy( &value, &bits, sizeof(value) );
+            return value;
+        }
+        inline double f64()
+        {
+            const auto bits = u64();
+            double value;
+            std::memcpy( &value, &bits, sizeof(value) );
+            return value;
+        }
+        inline double real(const bool& isDouble) { return isDouble ? f64() : static_cast<double>( f32() ); }
+
+        //
+        // read a string (length + padded characters)
+        //
+        inline std::string_view string()
+        {
+            const auto length = u32();
+            const auto* b = take( padded(length) );
+            return b ? std::string_view( reinterpret_cast<const char*>(b), length ) : std::string_view {};
+        }
+
+        //
+        // read raw bytes / skip bytes
+        //
+        inline const unsigned char* bytes(const std::size_t& n) { return take(n); }
+        inline void skip(const std::size_t& n) { take(n); }
+
+        inline const auto& getPosition() const { return position; }
+        inline bool good() const { return ok; }
+    };
+}
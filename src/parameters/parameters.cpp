@@ -71,6 +71,9 @@ void Parameters::read(int argc, char* argv[])
         ("reaction.computeLocalPotentialEnergy", po::bool_switch(), "compute local potential energies (only if reaction.mc)")
         ("reaction.computeSolvationPotentialEnergy", po::bool_switch(), "compute solvation interaction (only if reaction.mc)")
         ("reaction.saveRejected", po::bool_switch(), "save md files from failed reactive steps instead of deleting them")
+        ("reaction.threads", po::value<std::size_t>()->default_value(1), "number of threads for the reaction candidate search and for reading coordinates (0 is all available)")
+        ("reaction.skin",    po::value<REAL>()->default_value(0.1), "skin for the neighbour lists of the reaction candidate search (in nm)")
+        ("reaction.reuseTopology", po::bool_switch(), "after a rejected reactive step, keep the topology and candidate search structures and only refresh positions")
     ;
 
     // ... md engine related options
@@ -82,6 +85,7 @@ void Parameters::read(int argc, char* argv[])
         ("gromacs.mdp.energy",     po::value<std::string>()->default_value(""), "md parameter file for energy computation with solvation interaction (.mdp)")
         ("gromacs.mdp.relaxation", po::value<std::string>(), "md parameter file for relaxation (.mdp)")
         ("gromacs.backup",         po::bool_switch(), "whether or not gromacs should backup files or overwrite them")
+        ("gromacs.refineCoordinates", po::bool_switch(), "refine coordinates read from .gro files with the last frame of the trajectory (.trr/.xtc) of the same run, if it is their final configuration")
         ("gromacs.nt",             po::value<int>()->default_value(0), "total number of threads to start (0 is guess)")
         ("gromacs.ntmpi",          po::value<int>()->default_value(0), "number of thread-MPI ranks to start (0 is guess)")
         ("gromacs.ntomp",          po::value<int>()->default_value(0), "number of OpenMP threads per MPI rank to start (0 is guess)")
@@ -338,6 +342,9 @@ std::string Parameters::str() const
                << rsmdALL_formatting << formatted( "reaction.frequency", getOption("reaction.frequency").as<REAL>() ) << '\n';
     }
     stream << rsmdALL_formatting << formatted( "saveRejected", getOption("reaction.saveRejected").as<bool>() ) << '\n';
+    stream << rsmdALL_formatting << formatted( "reaction.threads", getOption("reaction.threads").as<std::size_t>() ) << '\n';
+    stream << rsmdALL_formatting << formatted( "reaction.skin", getOption("reaction.skin").as<REAL>() ) << '\n';
+    stream << rsmdALL_formatting << formatted( "reaction.reuseTopology", getOption("reaction.reuseTopology").as<bool>() ) << '\n';
 
     if( mdEngine == ENGINE::GROMACS )
     {
@@ -352,6 +359,7 @@ std::string Parameters::str() const
         }
         
         stream << rsmdALL_formatting << formatted("gromacs.backup", getOption("gromacs.backup").as<bool>() ) << '\n'
+               << rsmdALL_formatting << formatted("gromacs.refineCoordinates", getOption("gromacs.refineCoordinates").as<bool>() ) << '\n'
                << rsmdALL_formatting << formatted("gromacs.nt", getOption("gromacs.nt").as<int>() ) << '\n'
                << rsmdALL_formatting << formatted("gromacs.ntmpi", getOption("gromacs.ntmpi").as<int>() ) << '\n'
                << rsmdALL_formatting << formatted("gromacs.ntomp", getOption("gromacs.ntomp").as<int>() ) << '\n';
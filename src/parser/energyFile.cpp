@@ -0,0 +1,292 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "parser/energyFile.hpp"
+#include "enhance/xdrReader.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+    using enhance::XdrReader;
+
+    //
+    // magic numbers of the header (names of the energy terms) and of frames,
+    // frames begin with a real of the given value (in the precision of the file) before their magic number
+    //
+    constexpr std::int32_t namesMagic {-55555};
+    constexpr std::int32_t frameMagic {-7777777};
+    constexpr double       frameFirstReal {-2e10};
+
+    //
+    // supported file versions (of the header / of frames),
+    // (older versions differ in the layout of frames)
+    //
+    constexpr std::int32_t minNamesVersion {2};
+    constexpr std::int32_t minFrameVersion {4};
+    constexpr std::int32_t maxVersion {5};
+
+    //
+    // data types of subblocks
+    //
+    enum class XdrType : std::int32_t { INT, FLOAT, DOUBLE, INT64, CHAR, STRING };
+
+    //
+    // compare names of energy terms case-insensitively
+    //
+    inline bool equalNames(const std::string& lhs, const std::string& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal( lhs.begin(), lhs.end(), rhs.begin(), [](const char& a, const char& b)
+        {
+            return std::tolower( static_cast<unsigned char>(a) ) == std::tolower( static_cast<unsigned char>(b) );
+        });
+    }
+}
+
+
+
+//
+// read the names of the energy terms (+ their units, which are skipped)
+//
+std::size_t EnergyFile::readNames(std::string_view content)
+{
+    XdrReader xdr ( content, 0 );
+    if( xdr.i32() != namesMagic )   return 0;
+    const auto version = xdr.i32();
+    const auto nNames = xdr.i32();
+    if( ! xdr.good() || version < minNamesVersion || version > maxVersion || nNames < 0 )  return 0;
+    if( static_cast<std::size_t>(nNames) > content.size() / 8 )    return 0;
+
+    names.reserve( nNames );
+    for( std::int32_t i=0; i<nNames; ++i )
+    {
+        names.emplace_back( xdr.string() );
+        xdr.string();
+    }
+    return xdr.good() ? xdr.getPosition() : 0;
+}
+
+
+
+//
+// read a frame at the given offset
+// (the size of the frame is given by the number of energies and the sizes of its subblocks, which are listed in its header)
+//
+bool EnergyFile::readFrame(std::string_view content, const std::size_t& offset, Frame& frame)
+{
+    XdrReader xdr ( content, offset );
+    const double first = xdr.real( isDouble );
+    if( isDouble ? first != frameFirstReal : static_cast<float>(first) != static_cast<float>(frameFirstReal) )  return false;
+    if( xdr.i32() != frameMagic )   return false;
+    const auto version = xdr.i32();
+    if( version < minFrameVersion || version > maxVersion )     return false;
+
+    frame.begin = offset;
+    frame.time = xdr.f64();
+    xdr.i64();                              // step
+    const auto nSum = xdr.i32();
+    xdr.i64();                              // number of steps
+    if( version >= 5 )  xdr.f64();          // time step
+    const auto nEnergies = xdr.i32();
+    xdr.skip( 4 );                          // reserved
+    const auto nBlocks = xdr.i32();
+    if( ! xdr.good() || nEnergies < 0 || nBlocks < 0 )  return false;
+
+    subBlocks.clear();
+    for( std::int32_t b=0; b<nBlocks && xdr.good(); ++b )
+    {
+        xdr.skip( 4 );                      // block id
+        const auto nSubBlocks = xdr.i32();
+        if( nSubBlocks < 0 )    return false;
+        for( std::int32_t s=0; s<nSubBlocks && xdr.good(); ++s )
+        {
+            const auto type = xdr.i32();
+            const auto nItems = xdr.i32();
+            if( nItems < 0 )    return false;
+            subBlocks.emplace_back( type, nItems );
+        }
+    }
+    xdr.skip( 12 );                         // size of the energies + reserved
+
+    const std::size_t realSize = ( isDouble ? sizeof(double) : sizeof(float) );
+    frame.nEnergies = static_cast<std::size_t>( nEnergies );
+    frame.hasSums = ( nSum > 0 );
+    frame.energyOffset = xdr.getPosition();
+    xdr.skip( frame.nEnergies * realSize * ( frame.hasSums ? 3 : 1 ) );
+
+    for( const auto& [type, nItems]: subBlocks )
+    {
+        const auto n = static_cast<std::size_t>( nItems );
+        switch( static_cast<XdrType>(type) )
+        {
+            case XdrType::INT:
+            case XdrType::FLOAT:
+            case XdrType::CHAR:     xdr.skip( 4 * n ); break;
+            case XdrType::DOUBLE:
+            case XdrType::INT64:    xdr.skip( 8 * n ); break;
+            case XdrType::STRING:
+                for( std::size_t i=0; i<n && xdr.good(); ++i )
+                {
+                    xdr.skip( 4 );
+                    xdr.string();
+                }
+                break;
+            default:                return false;
+        }
+    }
+    frame.end = xdr.getPosition();
+    return xdr.good();
+}
+
+
+
+//
+// collect the frames with energies from the end of the file on:
+// the beginning of the frame that ends at the current position is searched backwards (in steps of 4 bytes, as all data is aligned)
+// via the magic number of frames, a candidate is only taken if it is a valid frame that ends exactly at the current position
+//
+bool EnergyFile::collectFramesBackward(std::string_view content, const std::size_t& firstFrame, const double& timeSpan)
+{
+    frames.clear();
+    const std::size_t realSize = ( isDouble ? sizeof(double) : sizeof(float) );
+    double margin {0};
+    std::size_t end = content.size();
+    while( end > firstFrame )
+    {
+        if( end < firstFrame + realSize + 4 )   return false;
+        std::size_t begin = end - realSize - 4;
+        begin -= ( begin - firstFrame ) % 4;
+
+        Frame frame {};
+        bool found {false};
+        while( true )
+        {
+            if( XdrReader( content, begin + realSize ).i32() == frameMagic && readFrame(content, begin, frame) && frame.end == end )
+            {
+                found = true;
+                break;
+            }
+            if( begin < firstFrame + 4 )    break;
+            begin -= 4;
+        }
+        if( ! found )   return false;
+        end = frame.begin;
+
+        if( frame.nEnergies == 0 )  continue;
+        if( frames.empty() )    margin = frame.time - timeSpan;
+        else if( timeSpan <= 0 || frame.time < margin )    break;
+        frames.push_back( frame );
+    }
+    return ! frames.empty();
+}
+
+
+//
+// collect the frames with energies from the beginning of the file on, and keep the ones at its end
+// (in reverse order, as collected backwards)
+//
+bool EnergyFile::collectFramesForward(std::string_view content, const std::size_t& firstFrame, const double& timeSpan)
+{
+    frames.clear();
+    std::size_t offset = firstFrame;
+    Frame frame {};
+    while( offset < content.size() && readFrame(content, offset, frame) )
+    {
+        if( frame.nEnergies != 0 )  frames.push_back( frame );
+        offset = frame.end;
+    }
+    if( offset < content.size() )
+    {
+        rsmdDEBUG( "... ignoring incomplete data at the end of the energy file (byte " << offset << ")" );
+    }
+    if( frames.empty() )    return false;
+
+    std::reverse( frames.begin(), frames.end() );
+    const double margin = frames.front().time - timeSpan;
+    const auto last = ( timeSpan <= 0 ? frames.begin() + 1 :
+        std::find_if( frames.begin(), frames.end(), [&](const auto& f){ return f.time < margin; }) );
+    frames.erase( last, frames.end() );
+    return true;
+}
+
+
+
+//
+// map a file and average the given energy terms over the given time span at its end
+//
+bool EnergyFile::read(const std::string& filename, const std::vector<std::string>& terms, const double& timeSpan)
+{
+    names.clear();
+    averages.assign( terms.size(), 0 );
+    time = 0;
+    nFrames = 0;
+    if( ! file.open( filename ) )   return false;
+    const auto content = file.view();
+
+    // indices of the requested terms (exact names first, otherwise case-insensitive)
+    const auto firstFrame = readNames( content );
+    bool valid = ( firstFrame != 0 );
+    std::vector<std::size_t> indices {};
+    for( const auto& term: terms )
+    {
+        if( ! valid )   break;
+        auto it = std::find( names.begin(), names.end(), term );
+        if( it == names.end() )     it = std::find_if( names.begin(), names.end(), [&](const auto& name){ return equalNames(name, term); });
+        if( it == names.end() )
+        {
+            rsmdWARNING( "energy term '" << term << "' not found in " << filename );
+            valid = false;
+        }
+        indices.push_back( static_cast<std::size_t>( it - names.begin() ) );
+    }
+
+    // precision of the file, given by the first real of the first frame
+    if( valid )
+    {
+        XdrReader single ( content, firstFrame );
+        XdrReader double_ ( content, firstFrame );
+        if( single.f32() == static_cast<float>(frameFirstReal) && single.i32() == frameMagic )     isDouble = false;
+        else if( double_.f64() == frameFirstReal && double_.i32() == frameMagic )                  isDouble = true;
+        else    valid = false;
+    }
+
+    // frames within the time span, found from the end of the file on if possible
+    if( valid && ! collectFramesBackward(content, firstFrame, timeSpan) )
+    {
+        rsmdDEBUG( "... searching frames of " << filename << " from its beginning" );
+        valid = collectFramesForward( content, firstFrame, timeSpan );
+    }
+
+    if( valid )
+    {
+        time = frames.front().time;
+        nFrames = frames.size();
+        const std::size_t realSize = ( isDouble ? sizeof(double) : sizeof(float) );
+        for( const auto& frame: frames )
+        {
+            if( frame.nEnergies != names.size() )
+            {
+                valid = false;
+                break;
+            }
+            const auto stride = realSize * ( frame.hasSums ? 3 : 1 );
+            for( std::size_t t=0; t<indices.size(); ++t )
+            {
+                averages[t] += XdrReader( content, frame.energyOffset + indices[t] * stride ).real( isDouble );
+            }
+        }
+        for( auto& average: averages )  average /= static_cast<double>( nFrames );
+    }
+
+    file.close();
+    return valid;
+}
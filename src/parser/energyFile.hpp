@@ -0,0 +1,93 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "definitions.hpp"
+#include "enhance/mappedFile.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+//
+// gromacs energy (.edr) file
+//
+// maps the file into memory, reads the names of the energy terms from its header and averages
+// the values of the requested terms over the frames at the end of the file:
+// - frames are searched from the end of the file on (via the magic number at their beginning,
+//   confirmed by their size, which has to end exactly where the following frame begins),
+//   such that only the frames within the requested time span are read, regardless of the length of the file
+// - if that fails (e.g. due to an incomplete last frame), frames are skipped from the beginning via their headers
+// frames without energies are ignored, as by gmx energy
+//
+
+class EnergyFile
+{
+    //
+    // position and content of a frame
+    //
+    struct Frame
+    {
+        std::size_t begin {0};
+        std::size_t end {0};
+        double      time {0};
+        std::size_t nEnergies {0};
+        std::size_t energyOffset {0};
+        bool        hasSums {false};     // every energy is followed by its average and sum
+    };
+
+    enhance::MappedFile file {};
+    std::vector<std::string> names {};
+    std::vector<double> averages {};
+    double      time {0};
+    std::size_t nFrames {0};
+
+    // precision (size of reals) of the file and buffers for reading frames
+    bool isDouble {false};
+    std::vector<Frame> frames {};
+    std::vector<std::pair<std::int32_t, std::int32_t>> subBlocks {};
+
+    //
+    // read the names of the energy terms, returns the offset of the first frame (0 if the header is malformed)
+    //
+    std::size_t readNames(std::string_view);
+
+    //
+    // read a frame at the given offset, returns false if there is no valid frame
+    //
+    bool readFrame(std::string_view, const std::size_t&, Frame&);
+
+    //
+    // collect the frames with energies from the end of the file on, down to the given time span before the last one
+    // (in reverse order), returns false if the frames can't be found from the end of the file
+    //
+    bool collectFramesBackward(std::string_view, const std::size_t&, const double&);
+    bool collectFramesForward(std::string_view, const std::size_t&, const double&);
+
+  public:
+    //
+    // map a file and average the given energy terms over the given time span (in ps) at its end,
+    // i.e. over all frames from (time of the last frame - time span) on (time span 0: the last frame only),
+    // returns false if the file doesn't exist, is malformed or doesn't contain all terms
+    //
+    bool read(const std::string&, const std::vector<std::string>&, const double& = 0);
+
+    //
+    // some getters
+    // (time of the last frame, number of averaged frames)
+    //
+    inline const auto& getNames()    const { return names; }
+    inline const auto& getAverages() const { return averages; }
+    inline const auto& getTime()     const { return time; }
+    inline const auto& getNFrames()  const { return nFrames; }
+};
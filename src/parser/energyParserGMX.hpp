@@ -12,14 +12,14 @@
 #pragma once
 
 #include "parser/energyParserBase.hpp"
+#include "parser/energyFile.hpp"
 
 #include <sstream>
-#include <fstream>
 
 //
 // energy parser class
 // reads energy differences from 
-// gromacs (GMX) files
+// gromacs (GMX) energy (.edr) files
 //
 
 
@@ -29,8 +29,8 @@ class EnergyParserGMX: public EnergyParserBase
     bool computeLocalPotentialEnergy {false};
     bool computeSolvationPotentialEnergy {false};
     REAL potentialEnergyAverageTime {0.0};
-    REAL readPotentialEnergy( const std::string& );
-    REAL readSolvationEnergy( const std::string& );
+    EnergyFile energyFile {};
+    REAL readEnergy( const std::string&, const std::vector<std::string>& );
 
 
   public:
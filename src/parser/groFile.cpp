@@ -0,0 +1,222 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "parser/groFile.hpp"
+
+#include <charconv>
+#include <thread>
+#include <algorithm>
+
+namespace
+{
+    //
+    // minimum number of atom lines per thread
+    //
+    constexpr std::size_t minLinesPerThread {1 << 14};
+
+    //
+    // remove leading / trailing whitespace
+    //
+    inline std::string_view trim(std::string_view s)
+    {
+        while( ! s.empty() && ( s.front() == ' ' || s.front() == '\t' ) )  s.remove_prefix(1);
+        while( ! s.empty() && ( s.back()  == ' ' || s.back()  == '\t' || s.back() == '\r' ) )  s.remove_suffix(1);
+        return s;
+    }
+
+    //
+    // parse a number that fills a (trimmed) field completely
+    //
+    template<typename T>
+    inline bool parseNumber(std::string_view field, T& value)
+    {
+        field = trim( field );
+        if( field.empty() ) return false;
+        const auto result = std::from_chars( field.data(), field.data() + field.size(), value );
+        return result.ec == std::errc() && result.ptr == field.data() + field.size();
+    }
+
+    //
+    // parse whitespace-separated numbers from the beginning of a line
+    //
+    template<typename T>
+    inline bool parseNumbers(std::string_view line, T* values, const std::size_t& n)
+    {
+        for( std::size_t i=0; i<n; ++i )
+        {
+            line = trim( line );
+            const auto result = std::from_chars( line.data(), line.data() + line.size(), values[i] );
+            if( result.ec != std::errc() )  return false;
+            line.remove_prefix( result.ptr - line.data() );
+        }
+        return true;
+    }
+}
+
+
+//
+// parse an atom line
+// (fixed columns: residue number, residue name, atom name, atom number (5 characters each),
+//  followed by three positions and optionally three velocities (fieldWidth characters each))
+//
+bool GroFile::parseRecord(std::string_view line, GroRecord& record) const
+{
+    if( ! line.empty() && line.back() == '\r' )     line.remove_suffix(1);
+    if( line.size() < 20 + 3 * fieldWidth )         return false;
+    record.line = line;
+
+    if( ! parseNumber( line.substr(0, 5), record.resid ) )      return false;
+    record.resname  = trim( line.substr(5, 5) );
+    record.atomname = trim( line.substr(10, 5) );
+    if( ! parseNumber( line.substr(15, 5), record.atomid ) )    return false;
+
+    for( std::size_t d=0; d<3; ++d )
+    {
+        if( ! parseNumber( line.substr(20 + d * fieldWidth, fieldWidth), record.position(d) ) )    return false;
+    }
+    if( line.size() >= 20 + 6 * fieldWidth )
+    {
+        for( std::size_t d=0; d<3; ++d )
+        {
+            if( ! parseNumber( line.substr(20 + (3 + d) * fieldWidth, fieldWidth), record.velocity(d) ) )  return false;
+        }
+    }
+    else
+    {
+        record.velocity(0) = record.velocity(1) = record.velocity(2) = 0;
+    }
+    return true;
+}
+
+
+//
+// parse the atom lines [first, last) of an atom block in which all lines have the given length
+// (stops at the first line that does not end at the expected position or is malformed)
+//
+std::size_t GroFile::parseFixed(const std::size_t& first, const std::size_t& last, const std::size_t& lineLength)
+{
+    for( std::size_t i=first; i<last; ++i )
+    {
+        const auto line = atomBlock.substr( i * lineLength, lineLength );
+        if( line.size() != lineLength || line.back() != '\n' )  return i - first;
+        if( ! parseRecord( line.substr(0, lineLength - 1), records[i] ) )  return i - first;
+    }
+    return last - first;
+}
+
+
+//
+// parse the atom lines from the given one on, starting at the given offset in the atom block,
+// one line after another, returns the offset after the last atom line
+//
+std::size_t GroFile::parseVariable(const std::size_t& first, std::size_t offset)
+{
+    for( std::size_t i=first; i<records.size(); ++i )
+    {
+        if( offset >= atomBlock.size() )    rsmdCRITICAL( filename << " ends after " << i << " of " << records.size() << " atoms" );
+        auto end = atomBlock.find( '\n', offset );
+        if( end == std::string_view::npos ) end = atomBlock.size();
+        if( ! parseRecord( atomBlock.substr(offset, end - offset), records[i] ) )
+            rsmdCRITICAL( "malformed atom line " << i + 3 << " in " << filename << ": '" << atomBlock.substr(offset, end - offset) << "'" );
+        offset = std::min( end + 1, atomBlock.size() );
+    }
+    return offset;
+}
+
+
+//
+// map and parse a file
+//
+void GroFile::read(const std::string& groFile, const std::size_t& nThreads)
+{
+    filename = groFile;
+    ++ generation;
+    if( ! file.open( filename ) )   rsmdCRITICAL( filename << " doesn't exist, cannot read structure" );
+    const auto content = file.view();
+
+    // first line: title, second line: number of atoms
+    std::size_t offset = 0;
+    auto nextLine = [&]()
+    {
+        auto end = content.find( '\n', offset );
+        if( end == std::string_view::npos ) end = content.size();
+        const auto line = content.substr( offset, end - offset );
+        offset = std::min( end + 1, content.size() );
+        return line;
+    };
+    title = trim( nextLine() );
+    std::size_t nAtoms {0};
+    if( ! parseNumbers( nextLine(), &nAtoms, 1 ) )  rsmdCRITICAL( "couldn't read number of atoms from " << filename );
+    records.resize( nAtoms );
+    atomBlock = content.substr( offset );
+
+    // atom lines: detect width of coordinate columns from the distance between the decimal points of the first line
+    if( nAtoms > 0 )
+    {
+        auto lineLength = atomBlock.find( '\n' );
+        if( lineLength == std::string_view::npos )  rsmdCRITICAL( filename << " ends after the first atom line" );
+        const auto firstLine = atomBlock.substr( 0, lineLength );
+        const auto p1 = firstLine.find( '.', 20 );
+        const auto p2 = ( p1 == std::string_view::npos ? p1 : firstLine.find( '.', p1 + 1 ) );
+        fieldWidth = ( p2 == std::string_view::npos ? 8 : p2 - p1 );
+        ++ lineLength;
+
+        // parse chunks of lines in parallel, if all lines have the same length
+        std::size_t nParsed = 0;
+        if( nAtoms * lineLength <= atomBlock.size() )
+        {
+            const auto nChunks = std::max( std::size_t {1}, std::min( nThreads, nAtoms / minLinesPerThread ) );
+            std::vector<std::size_t> parsed ( nChunks, 0 );
+            auto parseChunk = [&](const std::size_t& c)
+            {
+                parsed[c] = parseFixed( c * nAtoms / nChunks, (c + 1) * nAtoms / nChunks, lineLength );
+            };
+            std::vector<std::thread> threads {};
+            for( std::size_t c=1; c<nChunks; ++c )  threads.emplace_back( parseChunk, c );
+            parseChunk( 0 );
+            for( auto& thread: threads )    thread.join();
+            for( std::size_t c=0; c<nChunks; ++c )  nParsed += parsed[c];
+        }
+
+        if( nParsed == nAtoms )
+        {
+            offset = nAtoms * lineLength;
+        }
+        else
+        {
+            rsmdDEBUG( "atom lines of " << filename << " differ in length, parsing them one after another" );
+            offset = parseVariable( 0, 0 );
+        }
+    }
+    else
+    {
+        offset = 0;
+    }
+
+    // last line: box vector
+    auto boxLine = atomBlock.substr( offset );
+    boxLine = boxLine.substr( 0, boxLine.find('\n') );
+    float values[3] {0, 0, 0};
+    if( ! parseNumbers( boxLine, values, 3 ) )  rsmdCRITICAL( "couldn't read box vector from " << filename );
+    box = REALVEC( values[0], values[1], values[2] );
+}
+
+
+//
+// release the mapped file
+//
+void GroFile::close()
+{
+    file.close();
+    ++ generation;
+    records.clear();
+    title = atomBlock = std::string_view {};
+}
@@ -0,0 +1,94 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "definitions.hpp"
+#include "enhance/mappedFile.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+//
+// a single atom line of a .gro file
+// (names are views into the mapped file, i.e. only valid as long as the file is open)
+//
+
+struct GroRecord
+{
+    std::string_view line     {};
+    int              resid    {0};
+    std::string_view resname  {};
+    std::string_view atomname {};
+    int              atomid   {0};
+    REALVEC          position {0, 0, 0};
+    REALVEC          velocity {0, 0, 0};
+};
+
+
+
+//
+// gromacs structure (.gro) file
+//
+// maps the file into memory and parses its fixed-width columns in place, without allocations 
+// (apart from growing the reused record buffer):
+// - the width of the coordinate columns (i.e. the precision) is detected from the first atom line,
+//   as gromacs does, velocities are read if a line is long enough to contain them
+// - if all atom lines have the same length, the atom block is split into chunks that are parsed
+//   in parallel, otherwise the lines are parsed one after another
+// every read gets a new generation number, to identify the file the records refer to
+//
+
+class GroFile
+{
+    enhance::MappedFile file {};
+    std::string filename {};
+    std::vector<GroRecord> records {};
+    std::string_view title {};
+    std::string_view atomBlock {};
+    std::size_t fieldWidth {8};
+    REALVEC box {0, 0, 0};
+    std::size_t generation {0};
+
+    //
+    // parse an atom line, returns false if it is malformed
+    //
+    bool parseRecord(std::string_view, GroRecord&) const;
+
+    //
+    // parse the atom lines from the given one on, returns the number of parsed lines
+    // (fixed: all lines have the given length)
+    //
+    std::size_t parseFixed(const std::size_t&, const std::size_t&, const std::size_t&);
+    std::size_t parseVariable(const std::size_t&, std::size_t);
+
+  public:
+    //
+    // map and parse a file with the given number of threads
+    // (raises SIGABRT if the file doesn't exist or is malformed)
+    //
+    void read(const std::string&, const std::size_t& = 1);
+
+    //
+    // release the mapped file
+    //
+    void close();
+
+    //
+    // some getters
+    //
+    inline const auto& getRecords() const { return records; }
+    inline const auto& getTitle()   const { return title; }
+    inline const auto& getBox()     const { return box; }
+    inline const auto& getFieldWidth() const { return fieldWidth; }
+    inline const auto& getGeneration() const { return generation; }
+};
@@ -0,0 +1,268 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "parser/groWriter.hpp"
+
+#include <charconv>
+#include <thread>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <climits>
+
+namespace
+{
+    //
+    // minimum number of atoms per thread
+    //
+    constexpr std::size_t minAtomsPerThread {1 << 14};
+
+    //
+    // append a string / an integer to a buffer, padded to the given width
+    // (longer values are not truncated)
+    //
+    inline void appendPadded(std::string& out, const char* first, const char* last, const std::size_t& width, const bool& left = false)
+    {
+        const auto n = static_cast<std::size_t>( last - first );
+        if( ! left && n < width )   out.append( width - n, ' ' );
+        out.append( first, n );
+        if( left && n < width )     out.append( width - n, ' ' );
+    }
+
+    inline void appendInteger(std::string& out, std::size_t value, const std::size_t& width)
+    {
+        char digits[24];
+        char* p = digits + sizeof(digits);
+        do 
+        { 
+            *--p = static_cast<char>( '0' + value % 10 ); 
+            value /= 10; 
+        } while( value );
+        appendPadded( out, p, digits + sizeof(digits), width );
+    }
+
+    //
+    // check for inf / nan and for the sign via the bit pattern 
+    // (independent of -ffinite-math-only / -fno-signed-zeros, i.e. -0.0 is negative as for printf)
+    //
+    inline std::uint64_t bitPattern(const double& value)
+    {
+        std::uint64_t bits {0};
+        std::memcpy( &bits, &value, sizeof(bits) );
+        return bits;
+    }
+    inline bool isFinite(const double& value)
+    {
+        return ( bitPattern(value) & 0x7ff0000000000000ull ) != 0x7ff0000000000000ull;
+    }
+    inline bool isNegative(const double& value)
+    {
+        return ( bitPattern(value) & 0x8000000000000000ull ) != 0;
+    }
+
+    //
+    // append a fixed-point number with the given precision, padded to the given width:
+    // the value is scaled and rounded to an integer by hand, unless it is too close to a rounding tie 
+    // (or too large) for this to be exact, in which case it is converted by std::to_chars 
+    // (both give the correctly rounded result, as printf does)
+    //
+    inline void appendFixed(std::string& out, const double& value, const unsigned& precision, const std::size_t& width)
+    {
+        static constexpr double scales[] = {1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6};
+        char digits[64];
+        char* const last = digits + sizeof(digits);
+
+        if( isFinite(value) && precision < 7 )
+        {
+            const double scaled = std::abs(value) * scales[precision];
+            const double lower = std::floor( scaled );
+            const double fraction = scaled - lower;
+            if( scaled < 1e15 && std::abs(fraction - 0.5) > scaled * 1e-15 )
+            {
+                auto rounded = static_cast<std::uint64_t>( lower ) + ( fraction > 0.5 ? 1 : 0 );
+                char* p = last;
+                for( unsigned i=0; i<precision; ++i )
+                {
+                    *--p = static_cast<char>( '0' + rounded % 10 );
+                    rounded /= 10;
+                }
+                if( precision > 0 ) *--p = '.';
+                do 
+                { 
+                    *--p = static_cast<char>( '0' + rounded % 10 ); 
+                    rounded /= 10; 
+                } while( rounded );
+                if( isNegative(value) )     *--p = '-';
+                appendPadded( out, p, last, width );
+                return;
+            }
+        }
+        const auto result = std::to_chars( digits, last, value, std::chars_format::fixed, precision );
+        appendPadded( out, digits, result.ptr, width );
+    }
+
+    //
+    // write all buffers to a file with as few system calls as possible
+    //
+    inline bool writeBuffers(const int& fd, const std::vector<std::string>& buffers)
+    {
+        std::vector<iovec> chunks {};
+        for( const auto& buffer: buffers )
+        {
+            if( ! buffer.empty() )  chunks.push_back( iovec{ const_cast<char*>(buffer.data()), buffer.size() } );
+        }
+        std::size_t next = 0;
+        while( next < chunks.size() )
+        {
+            const auto nChunks = static_cast<int>( std::min<std::size_t>( chunks.size() - next, IOV_MAX ) );
+            auto written = ::writev( fd, chunks.data() + next, nChunks );
+            if( written < 0 )
+            {
+                if( errno == EINTR )    continue;
+                return false;
+            }
+            // skip completely written chunks, continue partially written one
+            while( next < chunks.size() && static_cast<std::size_t>(written) >= chunks[next].iov_len )
+            {
+                written -= chunks[next].iov_len;
+                ++ next;
+            }
+            if( next < chunks.size() )
+            {
+                chunks[next].iov_base = static_cast<char*>( chunks[next].iov_base ) + written;
+                chunks[next].iov_len -= written;
+            }
+        }
+        return true;
+    }
+}
+
+
+//
+// check whether the lines of a molecule can be copied from a .gro file,
+// i.e. the molecule refers to consecutive lines of the file with the same atoms
+//
+bool GroWriter::canSplice(const Molecule& mol, const GroFile& source)
+{
+    const auto& records = source.getRecords();
+    if( mol.getRecord() == Molecule::noRecord || mol.getRecord() + mol.size() > records.size() )  return false;
+    for( std::size_t a=0; a<mol.size(); ++a )
+    {
+        if( records[mol.getRecord() + a].atomname != mol[a].name.str() )   return false;
+    }
+    return true;
+}
+
+
+//
+// format the atom lines of the molecules [first, last)
+// (positions / velocities of unchanged molecules are copied from the lines they were read from,
+//  missing velocities are written as zeros, as they were read)
+//
+void GroWriter::formatMolecules(const Topology& top, const std::size_t& first, const std::size_t& last, const GroFile* source, std::string& buffer)
+{
+    static constexpr std::string_view zeroVelocities {"  0.0000  0.0000  0.0000"};
+    buffer.clear();
+    for( std::size_t m=first; m<last; ++m )
+    {
+        const auto& mol = top[m];
+        const auto& molname = mol.getName().str();
+        const bool splice = ( source && canSplice(mol, *source) );
+        for( std::size_t a=0; a<mol.size(); ++a )
+        {
+            const auto& atom = mol[a];
+            const auto& atomname = atom.name.str();
+            appendInteger( buffer, mol.getID(), 5 );
+            appendPadded( buffer, molname.data(), molname.data() + molname.size(), 5, true );
+            appendPadded( buffer, atomname.data(), atomname.data() + atomname.size(), 5 );
+            appendInteger( buffer, atom.id, 5 );
+            if( splice )
+            {
+                const auto& line = source->getRecords()[mol.getRecord() + a].line;
+                if( line.size() >= 68 ) buffer.append( line.substr(20, 48) );
+                else
+                {
+                    buffer.append( line.substr(20, 24) );
+                    buffer.append( zeroVelocities );
+                }
+            }
+            else
+            {
+                for( const auto& p: atom.position )     appendFixed( buffer, p, 3, 8 );
+                for( const auto& v: atom.velocity )     appendFixed( buffer, v, 4, 8 );
+            }
+            buffer.push_back( '\n' );
+        }
+    }
+}
+
+
+//
+// write a topology
+//
+void GroWriter::write(const std::string& groFile, const std::string& title, const Topology& top, const std::size_t& nThreads, const GroFile* source)
+{
+    // lines can only be copied from the file the molecules were read from, if it has the same precision
+    if( source && ( top.getSource() != source->getGeneration() || source->getFieldWidth() != 8 ) )  source = nullptr;
+
+    // split molecules into chunks with about the same number of atoms
+    const std::size_t nAtoms = top.getNAtoms();
+    const auto nChunks = std::max( std::size_t {1}, std::min( nThreads, nAtoms / minAtomsPerThread ) );
+    std::vector<std::size_t> boundaries ( nChunks + 1, top.size() );
+    boundaries[0] = 0;
+    std::size_t counter = 0;
+    std::size_t c = 1;
+    for( std::size_t m=0; m<top.size() && c<nChunks; ++m )
+    {
+        counter += top[m].size();
+        if( counter >= c * nAtoms / nChunks )   boundaries[c++] = m + 1;
+    }
+
+    // first two lines: title and # of atoms, last line: box dimensions
+    buffers.resize( nChunks + 2 );
+    auto& header = buffers.front();
+    header.assign( title );
+    header.push_back( '\n' );
+    appendInteger( header, nAtoms, 6 );
+    header.push_back( '\n' );
+
+    auto& footer = buffers.back();
+    footer.clear();
+    for( const auto& d: top.getDimensions() )
+    {
+        // note: fixed notation only applies once atoms have been written (as with iostreams)
+        if( nAtoms > 0 )    appendFixed( footer, d, 6, 10 );
+        else
+        {
+            char digits[64];
+            const auto result = std::to_chars( digits, digits + sizeof(digits), static_cast<double>(d), std::chars_format::general, 6 );
+            appendPadded( footer, digits, result.ptr, 10 );
+        }
+    }
+    footer.push_back( '\n' );
+
+    // atom lines
+    std::vector<std::thread> threads {};
+    for( std::size_t i=1; i<nChunks; ++i )  threads.emplace_back( formatMolecules, std::cref(top), boundaries[i], boundaries[i+1], source, std::ref(buffers[i+1]) );
+    formatMolecules( top, boundaries[0], boundaries[1], source, buffers[1] );
+    for( auto& thread: threads )    thread.join();
+
+    // write everything at once
+    const int fd = ::open( groFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644 );
+    if( fd < 0 )    rsmdCRITICAL( "something went wrong with outstream to " << groFile );
+    const bool written = writeBuffers( fd, buffers );
+    ::close( fd );
+    if( ! written ) rsmdCRITICAL( "something went wrong with outstream to " << groFile );
+}
@@ -0,0 +1,56 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "definitions.hpp"
+#include "container/topology.hpp"
+#include "parser/groFile.hpp"
+
+#include <string>
+#include <vector>
+
+//
+// gromacs structure (.gro) writer
+//
+// formats the atom lines of a topology into contiguous buffers and writes them at once:
+// - integers and fixed-point numbers are converted by hand (values that are too close to a
+//   rounding tie for this to be exact are converted with std::to_chars),
+//   the output is the same as formatting with iostreams 
+//   (%5d%-5s%5s%5d, positions %8.3f, velocities %8.4f, box %10.6f)
+// - large topologies are split into chunks of molecules that are formatted in parallel 
+//   into separate buffers, which are written with a single system call
+// - if the molecules of the topology were read from a given .gro file (with the default precision),
+//   the lines of unchanged molecules are copied from it and only their numbers and names are formatted,
+//   i.e. positions / velocities are not formatted again
+//
+
+class GroWriter
+{
+    std::vector<std::string> buffers {};
+
+    //
+    // format the atom lines of the molecules [first, last) into a buffer
+    //
+    static void formatMolecules(const Topology&, const std::size_t&, const std::size_t&, const GroFile*, std::string&);
+
+    //
+    // check whether the lines of a molecule can be copied from a .gro file
+    //
+    static bool canSplice(const Molecule&, const GroFile&);
+
+  public:
+    //
+    // write a topology with the given title, using the given number of threads
+    // (+ the .gro file its molecules might have been read from)
+    //
+    void write(const std::string&, const std::string&, const Topology&, const std::size_t& = 1, const GroFile* = nullptr);
+};
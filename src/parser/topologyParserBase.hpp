@@ -15,6 +15,9 @@
 #include "container/topology.hpp"
 #include "parameters/parameters.hpp"
 
+#include <unordered_set>
+#include <algorithm>
+
 //
 // a base class that implements
 // the interface for all topology readers/writers
@@ -25,9 +28,16 @@ class TopologyParserBase
   protected:
     TopologyParserBase() = default;
 
+    // number of threads for parsing
+    std::size_t nThreads {1};
+
   public:
+    inline void setThreads(const std::size_t& n) { nThreads = std::max( n, std::size_t {1} ); }
+
     virtual void read( Topology&, const std::size_t&) = 0;
     virtual void readRelaxed( Topology&, const std::size_t&) = 0;
+    virtual void readRelaxed( Topology&, const std::size_t&, const std::unordered_set<std::size_t>&) = 0;
+    virtual bool readCoordinates( Topology&, const std::size_t&) = 0;
     virtual void write(Topology&, const std::size_t&) = 0;
 
     virtual ~TopologyParserBase() = default;
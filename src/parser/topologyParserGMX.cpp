@@ -22,15 +22,16 @@ void TopologyParserGMX::read( Topology& topology, const std::size_t& cycle )
     // read topology
     auto topologyMap = read_top( topFile.str() );
     read_gro( coordFile.str(), topology );
+    refine_positions( std::to_string(cycle) + "-md", topology );
 
     // some consistency checks:
     unsigned int atomCounter = 0;
     for( const auto& moleculetype: topologyMap )
     {
-        auto foundMolecules = topology.getMolecules( moleculetype.first );
-        if( foundMolecules.size() != moleculetype.second )   
-            rsmdWARNING(".top and .gro don't match (# molecules of type " << moleculetype.first << " " << moleculetype.second << " vs. " << foundMolecules.size() << ")") 
-        atomCounter += foundMolecules.size();
+        auto nFoundMolecules = topology.getNMolecules( moleculetype.first );
+        if( nFoundMolecules != moleculetype.second )   
+            rsmdWARNING(".top and .gro don't match (# molecules of type " << moleculetype.first << " " << moleculetype.second << " vs. " << nFoundMolecules << ")") 
+        atomCounter += nFoundMolecules;
     }
     if( atomCounter != topology.size() )
         rsmdWARNING( " total number of molecules in .gro and .top doesn't match" << "(" << atomCounter << " vs. " << topology.size() << ")" )
@@ -52,16 +53,45 @@ void TopologyParserGMX::readRelaxed( Topology& topology, const std::size_t& cycl
     unsigned int atomCounter = 0;
     for( const auto& moleculetype: topologyMap )
     {
-        auto foundMolecules = topology.getMolecules( moleculetype.first );
-        if( foundMolecules.size() != moleculetype.second )   
-            rsmdWARNING(".top and .gro don't match (# molecules of type " << moleculetype.first << " " << moleculetype.second << " vs. " << foundMolecules.size() << ")") 
-        atomCounter += foundMolecules.size();
+        auto nFoundMolecules = topology.getNMolecules( moleculetype.first );
+        if( nFoundMolecules != moleculetype.second )   
+            rsmdWARNING(".top and .gro don't match (# molecules of type " << moleculetype.first << " " << moleculetype.second << " vs. " << nFoundMolecules << ")") 
+        atomCounter += nFoundMolecules;
     }
     if( atomCounter != topology.size() )
         rsmdWARNING( " total number of molecules in .gro and .top doesn't match" << "(" << atomCounter << " vs. " << topology.size() << ")" )
 }
 
 
+//
+// read only the given molecules (by ID) of the relaxed configuration of a cycle
+// (without reading the .top file, and without consistency checks)
+// positions of all reads are refined with the trajectory of the run, if it contains its final configuration
+//
+void TopologyParserGMX::readRelaxed( Topology& topology, const std::size_t& cycle, const std::unordered_set<std::size_t>& moleculeIDs )
+{
+    std::stringstream coordFile {};
+    coordFile << cycle << "-rs.gro";
+    read_gro( coordFile.str(), topology, &moleculeIDs );
+    refine_positions( std::to_string(cycle) + "-rs", topology );
+}
+
+
+//
+// refresh positions, velocities and box of an already read topology from the coordinates of a cycle
+// (without reading the .top file or rebuilding molecules),
+// returns false if the coordinates don't match the molecules of the topology
+//
+bool TopologyParserGMX::readCoordinates( Topology& topology, const std::size_t& cycle )
+{
+    std::stringstream coordFile {};
+    coordFile << cycle << "-md.gro";
+    if( ! update_gro( coordFile.str(), topology ) )    return false;
+    refine_positions( std::to_string(cycle) + "-md", topology );
+    return true;
+}
+
+
 void TopologyParserGMX::write(Topology& top, const std::size_t& currentCycle)
 {
     rsmdDEBUG(__PRETTY_FUNCTION__);
@@ -78,17 +108,32 @@ void TopologyParserGMX::write(Topology& top, const std::size_t& currentCycle)
 
 
 
+//
+// read the molecule counts (and the system name) of a .top file
+// the file is only parsed if it is not the latest read or written .top file, or if it changed on disk since,
+// in which case its contents up to the [ molecules ] directive are kept for writing .top files
+//
 std::map<std::string, unsigned int> TopologyParserGMX::read_top( const std::string& topFile )
 {
-    std::map<std::string, unsigned int> topologyMap {};
+    std::error_code timeError {};
+    std::error_code sizeError {};
+    const auto time = std::filesystem::last_write_time( topFile, timeError );
+    const auto size = std::filesystem::file_size( topFile, sizeError );
+    if( ! timeError && ! sizeError && topFile == topologyFile && time == topologyTime && size == topologySize )
+    {
+        rsmdDEBUG( topFile << " didn't change, using its molecule counts in memory" );
+        return topologyCounts;
+    }
 
-    bool readFileContent = (topologyFileContent.empty() ? true : false);
+    std::map<std::string, unsigned int> topologyMap {};
 
 	// open topology file
 	std::ifstream FILE( topFile );
 	if( ! FILE ){   // safety check
 		rsmdCRITICAL( topFile << " doesn't exist, cannot read topology" )
 	} else {
+        topologyPrefix.clear();
+        topologyHasMolecules = false;
         bool directiveMolecules {false};
         bool directiveSystem    {false};
         while( FILE.good() )
@@ -103,6 +148,7 @@ std::map<std::string, unsigned int> TopologyParserGMX::read_top( const std::stri
             {
                 if( line.empty() ) continue;
                 systemName = enhance::trimString(line);
+                topologyPrefix.append( systemName ).push_back( '\n' );
                 directiveSystem = false;
             }
             // case: [molecules] --> read and save 
@@ -117,6 +163,9 @@ std::map<std::string, unsigned int> TopologyParserGMX::read_top( const std::stri
             // case else --> check if line containes a directive
             else
             {   
+                // save line to the contents of the file
+                topologyPrefix.append( line ).push_back( '\n' );
+
                 // any kind of directive []
                 if( line.find('[') != std::string::npos )
                 {
@@ -133,165 +182,212 @@ std::map<std::string, unsigned int> TopologyParserGMX::read_top( const std::stri
                     {   
                         directiveSystem = false;
                         directiveMolecules = true;
+                        topologyHasMolecules = true;
                     }
                 }
-                // read and save line to topologyFileContent
-                if( readFileContent )
-                {
-                    topologyFileContent.emplace_back(line);
-                }
             }
         }
     }   
 	FILE.close();
 
+    topologyCounts = topologyMap;
+    remember_top( topFile );
+
     return topologyMap;
 }
 
 
+//
+// remember the state on disk of the latest read or written .top file
+// (molecule counts have to be set beforehand)
+//
+void TopologyParserGMX::remember_top( const std::string& topFile )
+{
+    std::error_code timeError {};
+    std::error_code sizeError {};
+    topologyTime = std::filesystem::last_write_time( topFile, timeError );
+    topologySize = std::filesystem::file_size( topFile, sizeError );
+    topologyFile = ( timeError || sizeError ) ? std::string {} : topFile;
+}
+
+
 
-void TopologyParserGMX::read_gro( const std::string& groFile, Topology& top )
+//
+// read a .gro file into a topology
+// (if molecule IDs are given, all other molecules are skipped)
+// the file is parsed (in parallel) by GroFile, the topology is then filled in one pass,
+// with names interned once per distinct string of the file
+// (molecules remember the record of their first atom, if their atoms are consecutive lines of the file)
+//
+void TopologyParserGMX::read_gro( const std::string& groFile, Topology& top, const std::unordered_set<std::size_t>* moleculeIDs )
 {	
-	int totNrOfAtoms = 0;
-	
-	// open .gro file
-	std::ifstream FILE( groFile );
-	
-	if( ! FILE ){   // check if file exists
-       rsmdCRITICAL(groFile << " doesn't exist, cannot read structure")
-	} else {			
-		
-		// first line: system name
-		std::string line;
-		std::getline(FILE, line, '\n');
-        line = enhance::trimString(line);
-        if( line != systemName )    rsmdWARNING("system names don't agree (" << systemName << " vs. " << line << ")")
-
-        // second line: number of atoms
-        std::getline(FILE, line, '\n');
-        std::stringstream linestream(line);
-        linestream >> totNrOfAtoms;
-
-        // read atom descriptions
-        int counter = 0;
-        while( counter < totNrOfAtoms )
+    gro.read( groFile, nThreads );
+    if( gro.getTitle() != systemName )    rsmdWARNING("system names don't agree (" << systemName << " vs. " << gro.getTitle() << ")")
+
+    symbols.clear();
+    auto symbol = [&](const std::string_view& name) -> const enhance::Symbol&
+    {
+        auto it = symbols.find( name );
+        if( it == symbols.end() )   it = symbols.emplace( name, enhance::Symbol( std::string(name) ) ).first;
+        return it->second;
+    };
+
+    // add atoms and all infos to topology
+    // (the molecule is only looked up when the residue number changes)
+    Molecule* mol {nullptr};
+    int resid {0};
+    const auto& records = gro.getRecords();
+    for( std::size_t r=0; r<records.size(); ++r )
+    {
+        const auto& record = records[r];
+        if( moleculeIDs && moleculeIDs->count(record.resid) == 0 )  continue;
+        if( ! mol || record.resid != resid )
         {
-            std::getline(FILE, line, '\n');
-            if(line.size() == 44)
-            {
-                line.append(std::string("  0.0000"));   // append empty velocities
-                line.append(std::string("  0.0000"));
-                line.append(std::string("  0.0000"));
-            }
-           
-            // molecule related information
-            int resid           = std::stoi( line.substr(0,5) );
-            std::string resname = line.substr(5,5);
-            resname.erase(std::remove_if( resname.begin(), resname.end(), ::isspace), resname.end());
-           
-            // atom related information
-            Atom atom;
-            atom.name = line.substr(10,5);
-            atom.name.erase(std::remove_if( atom.name.begin(), atom.name.end(), ::isspace), atom.name.end());
-            atom.id = std::stoi( line.substr(15,5) );
-            atom.position(0) = std::stof( line.substr(20,8) );
-            atom.position(1) = std::stof( line.substr(28,8) );
-            atom.position(2) = std::stof( line.substr(36,8) );
-            atom.velocity(0)= std::stof( line.substr(44,8) );
-            atom.velocity(1) = std::stof( line.substr(52,8) );
-            atom.velocity(2) = std::stof( line.substr(60,8) );
-
-            // add atom and all infos to topology:
-            auto& mol = top.getAddMolecule( resid, resname );
-            mol.addAtom(atom);
-
-            counter ++;
+            mol = &top.getAddMolecule( record.resid, symbol(record.resname) );
+            mol->setRecord( mol->empty() ? r : Molecule::noRecord );
+            resid = record.resid;
         }
+        auto atom = mol->addAtom( record.atomid, symbol(record.atomname) );
+        atom->position = record.position;
+        atom->velocity = record.velocity;
+    }
+    top.setDimensions( gro.getBox() );
+    top.setSource( gro.getGeneration() );
+}
 
-        // last line: box vector
-        std::getline(FILE, line, '\n');
-        std::stringstream tmpstream(line);
-        REALVEC box;
-        tmpstream >> box(0) >> box(1) >> box(2);
-        top.setDimensions(box);
 
-	}
-	
-	// close file
-	FILE.close();
-	
+
+//
+// read atom positions / velocities from a .gro file into the atoms of a topology
+// (atoms are matched in the order of the file, which has to be the order of the molecules in the topology)
+//
+bool TopologyParserGMX::update_gro( const std::string& groFile, Topology& top )
+{
+    gro.read( groFile, nThreads );
+    const auto& records = gro.getRecords();
+    if( records.size() != static_cast<std::size_t>(top.getNAtoms()) )   return false;
+
+    auto record = records.begin();
+    for( auto& mol: top )
+    {
+        mol.setRecord( static_cast<std::size_t>( record - records.begin() ) );
+        for( auto& atom: mol )
+        {
+            if( record->resid != static_cast<int>(mol.getID()) || record->atomid != static_cast<int>(atom.id) )    return false;
+            atom.position = record->position;
+            atom.velocity = record->velocity;
+            ++ record;
+        }
+    }
+    top.setDimensions( gro.getBox() );
+    top.setSource( gro.getGeneration() );
+    return true;
 }
 
 
 
-void TopologyParserGMX::write_top( const std::string& topFile, Topology& top )
+//
+// refine the positions (and velocities) of the molecules read from the latest read .gro file with the last frame
+// of the trajectory of the same run (<key>.trr, otherwise <key>.xtc if it is more precise than the .gro file):
+// mdrun doesn't necessarily write its final configuration to the trajectory, so the frame is only used
+// if it contains all atoms of the .gro file at the same positions (within the precision of both files),
+// positions are kept in the periodic image of the .gro file, returns true if the frame was used
+// (only if requested, as the .gro file is read anyways)
+// a refined topology no longer refers to the .gro file, such that its molecules are formatted when written
+//
+bool TopologyParserGMX::refine_positions( const std::string& key, Topology& top )
 {
-    std::ofstream FILE( topFile );
-    if( FILE.bad() ) rsmdCRITICAL("something went wrong with outstream to " << topFile);
-    
-    for(auto& line: topologyFileContent)
+    if( ! refineCoordinates )   return false;
+    if( top.getSource() != gro.getGeneration() || gro.getBox().isZero() )  return false;
+
+    const auto& records = gro.getRecords();
+    const double groPrecision = std::pow( 10.0, static_cast<double>(gro.getFieldWidth()) - 5 );
+    std::string filename {};
+    for( const auto& extension: {".trr", ".xtc"} )
+    {
+        filename = key + extension;
+        if( std::filesystem::exists(filename) && trajectory.readLastFrame(filename, 2 * groPrecision) 
+            && trajectory.getPositions().size() == records.size() )     break;
+        filename.clear();
+    }
+    if( filename.empty() )  return false;
+
+    // check that the frame is the configuration of the .gro file
+    // (both are rounded, with some slack for the rounding of floats)
+    const auto& positions = trajectory.getPositions();
+    const auto& velocities = trajectory.getVelocities();
+    const auto& box = gro.getBox();
+    REAL tolerance = static_cast<REAL>( 0.51 / groPrecision );
+    if( trajectory.getPrecision() > 0 )     tolerance += static_cast<REAL>( 0.51 / trajectory.getPrecision() );
+    for( std::size_t r=0; r<records.size(); ++r )
     {
-        // if line contains [system]
-        if( line.find('[') != std::string::npos && line.find("system") != std::string::npos )
+        const auto shift = enhance::distanceVector( records[r].position, positions[r], box );
+        if( std::abs(shift(0)) > tolerance || std::abs(shift(1)) > tolerance || std::abs(shift(2)) > tolerance )
         {
-            FILE << line << '\n';
-            FILE << systemName << '\n';
+            rsmdDEBUG( "... last frame of " << filename << " is not the final configuration (atom " << r + 1 << ")" );
+            return false;
         }
-        // if line contains [molecules]
-        else if( line.find('[') != std::string::npos && line.find("molecules") != std::string::npos )
-        {
-            FILE << line << '\n';
-            for(auto& mt: top.getMoleculetypes() )
-            {
-                auto number = top.getMolecules( mt ).size();       
-                FILE << std::setw(5) << std::left << mt << number << '\n';
-            }
-        }  
-        else
+    }
+
+    // take positions and velocities of the atoms of all molecules with a record
+    for( auto& mol: top )
+    {
+        const auto record = mol.getRecord();
+        if( record == Molecule::noRecord || record + mol.size() > records.size() )  continue;
+        for( std::size_t a=0; a<mol.size(); ++a )
         {
-            FILE << line << '\n';
+            const auto r = record + a;
+            mol[a].position = records[r].position + enhance::distanceVector( records[r].position, positions[r], box );
+            if( ! velocities.empty() )  mol[a].velocity = velocities[r];
         }
     }
-    
-    FILE.close();
-}
+    rsmdDEBUG( "... refined positions " << ( velocities.empty() ? "" : "and velocities " ) << "with the last frame of " << filename );
 
+    // the lines of the .gro file no longer hold the coordinates of the molecules, i.e. they must not be copied when writing
+    top.setSource( 0 );
+    return true;
+}
 
-void TopologyParserGMX::write_gro( const std::string& groFile, Topology& top )
-{
 
-    std::ofstream FILE( groFile );
-    if( FILE.bad() ) rsmdCRITICAL("something went wrong with outstream to " << groFile);
 
-    // first two lines: system name / other info and # of atoms
-    FILE << systemName << " (created by reactiveMD)" << '\n';
-    FILE << std::setw(6) << top.getNAtoms() << '\n';
-    
-    // assumes that topology has been sorted beforehand
-    // (gromacs needs molecules sorted according to types and this has to match the sequence in .top !)
-    for( const auto& mol: top )
+//
+// write a .top file, i.e. the contents of the latest parsed .top file with the molecule counts of the topology
+// (in a single write, the molecule counts are remembered for reading the file in the next cycle)
+//
+void TopologyParserGMX::write_top( const std::string& topFile, Topology& top )
+{
+    std::string buffer = topologyPrefix;
+    topologyCounts.clear();
+    if( topologyHasMolecules )
     {
-        for(const auto& atom: mol)
+        for(auto& mt: top.getMoleculetypes() )
         {
-            FILE << std::setw(5) << std::right << mol.getID() 
-                 << std::setw(5) << std::left  << mol.getName()
-                 << std::setw(5) << std::right << atom.name
-                 << std::setw(5) << std::right << atom.id;
-            for( const auto& p: atom.position )
-                FILE << std::fixed << std::right << std::setprecision(3) << std::setw(8) << p;
-            for( const auto& v: atom.velocity )
-                FILE << std::fixed << std::right << std::setprecision(4) << std::setw(8) << v;
-            FILE << '\n';
+            const auto number = top.getNMolecules( mt );
+            topologyCounts[mt.str()] = number;
+            buffer.append( mt.str() );
+            if( mt.str().size() < 5 )   buffer.append( 5 - mt.str().size(), ' ' );
+            buffer.append( std::to_string(number) ).push_back( '\n' );
         }
     }
 
-    // box dimensions
-    for( const auto& d: top.getDimensions() )
-        FILE << std::setw(10) << std::setprecision(6) << d;
-    FILE << '\n';
-    
+    std::ofstream FILE( topFile, std::ios::binary );
+    FILE.write( buffer.data(), static_cast<std::streamsize>(buffer.size()) );
+    if( ! FILE ) rsmdCRITICAL("something went wrong with outstream to " << topFile);
     FILE.close();
-    
+
+    remember_top( topFile );
+}
+
+
+//
+// write a .gro file
+// (assumes that topology has been sorted beforehand,
+//  gromacs needs molecules sorted according to types and this has to match the sequence in .top !)
+// molecules that were read from the latest read .gro file are written by reusing their lines
+//
+void TopologyParserGMX::write_gro( const std::string& groFile, Topology& top )
+{
+    groWriter.write( groFile, systemName + " (created by reactiveMD)", top, nThreads, &gro );
 }
 
 
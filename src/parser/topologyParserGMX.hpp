@@ -12,6 +12,10 @@
 #pragma once
 
 #include "parser/topologyParserBase.hpp"
+#include "parser/groFile.hpp"
+#include "parser/groWriter.hpp"
+#include "parser/trajectoryFile.hpp"
+#include "enhance/math_utility.hpp"
 #include "enhance/utility.hpp"
 
 #include <vector>
@@ -20,6 +24,8 @@
 #include <iomanip>
 #include <fstream>
 #include <map>
+#include <unordered_map>
+#include <string_view>
 #include <algorithm>
 #include <filesystem>
 
@@ -33,18 +39,44 @@ class TopologyParserGMX : public TopologyParserBase
 {
   private:
     std::string              systemName {};
-    std::vector<std::string> topologyFileContent {};
+
+    // contents of the latest parsed .top file up to the [ molecules ] directive (with the system name),
+    // + the latest .top file that was read or written, its state on disk and its molecule counts
+    // (a .top file is only parsed again if it is a different file or if it changed on disk)
+    std::string topologyPrefix {};
+    bool        topologyHasMolecules {false};
+    std::string topologyFile {};
+    std::filesystem::file_time_type topologyTime {};
+    std::uintmax_t topologySize {0};
+    std::map<std::string, unsigned int> topologyCounts {};
+
+    // latest read .gro file (+ symbols of the names in it), buffers for writing .gro files
+    GroFile gro {};
+    std::unordered_map<std::string_view, enhance::Symbol> symbols {};
+    GroWriter groWriter {};
+
+    // last frame of the latest read trajectory (.trr / .xtc),
+    // used to refine the coordinates read from .gro files only if requested
+    TrajectoryFile trajectory {};
+    bool refineCoordinates {false};
 
     std::map<std::string, unsigned int> read_top( const std::string& );
-    void read_gro( const std::string&, Topology&);
+    void remember_top( const std::string& );
+    void read_gro( const std::string&, Topology&, const std::unordered_set<std::size_t>* = nullptr);
+    bool update_gro( const std::string&, Topology&);
+    bool refine_positions( const std::string&, Topology&);
     void write_top(const std::string&, Topology&);
     void write_gro(const std::string&, Topology&);
     void write_index(const std::string&, const std::string&, Topology&);
 
 
   public:
+    inline void setRefineCoordinates(const bool& refine) { refineCoordinates = refine; }
+
     void read( Topology&, const std::size_t&);
     void readRelaxed( Topology&, const std::size_t&);
+    void readRelaxed( Topology&, const std::size_t&, const std::unordered_set<std::size_t>&);
+    bool readCoordinates( Topology&, const std::size_t&);
     void write(Topology&, const std::size_t&);
 
 };
@@ -0,0 +1,544 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "parser/trajectoryFile.hpp"
+#include "enhance/xdrReader.hpp"
+
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <filesystem>
+
+namespace
+{
+    using enhance::XdrReader;
+
+    //
+    // magic numbers of frames
+    // (xtc frames of large systems (gromacs 2023+) store the byte count of the compressed positions as 64 bit integer)
+    //
+    constexpr std::int32_t trrMagic      {1993};
+    constexpr std::int32_t xtcMagic      {1995};
+    constexpr std::int32_t xtcMagicLarge {2023};
+
+    constexpr std::size_t noFrame {std::numeric_limits<std::size_t>::max()};
+
+    //
+    // header of a .trr frame
+    // (sizes in bytes of the data blocks following the header, in this order)
+    //
+    struct TRRHeader
+    {
+        std::size_t boxSize  {0};
+        std::size_t virSize  {0};
+        std::size_t presSize {0};
+        std::size_t xSize    {0};
+        std::size_t vSize    {0};
+        std::size_t fSize    {0};
+        std::size_t nAtoms   {0};
+        std::int64_t step {0};
+        double time {0};
+        bool isDouble {false};
+
+        inline std::size_t dataSize() const { return boxSize + virSize + presSize + xSize + vSize + fSize; }
+    };
+
+    //
+    // read the header of a .trr frame, returns false if there is no valid header
+    // (the precision of the frame is given by the size of its data blocks, as in gromacs)
+    //
+    bool readTRRHeader(XdrReader& xdr, TRRHeader& header)
+    {
+        if( xdr.i32() != trrMagic ) return false;
+        xdr.skip( 4 );                          // length of the version string (incl. terminating 0)
+        xdr.string();                           // version string
+
+        std::array<std::int32_t, 11> sizes {};  // ir, e, box, vir, pres, top, sym, x, v, f, natoms
+        for( auto& size: sizes )    size = xdr.i32();
+        if( ! xdr.good() || std::any_of( sizes.begin(), sizes.end(), [](const auto& size){ return size < 0; } ) )  return false;
+        header.boxSize  = static_cast<std::size_t>( sizes[2] );
+        header.virSize  = static_cast<std::size_t>( sizes[3] );
+        header.presSize = static_cast<std::size_t>( sizes[4] );
+        header.xSize    = static_cast<std::size_t>( sizes[7] );
+        header.vSize    = static_cast<std::size_t>( sizes[8] );
+        header.fSize    = static_cast<std::size_t>( sizes[9] );
+        header.nAtoms   = static_cast<std::size_t>( sizes[10] );
+
+        std::size_t realSize {0};
+        if( header.boxSize != 0 )   realSize = header.boxSize / 9;
+        else if( header.nAtoms != 0 )   realSize = std::max( { header.xSize, header.vSize, header.fSize } ) / ( 3 * header.nAtoms );
+        if( realSize != sizeof(float) && realSize != sizeof(double) )   return false;
+        header.isDouble = ( realSize == sizeof(double) );
+        for( const auto& size: {header.xSize, header.vSize, header.fSize} )
+        {
+            if( size != 0 && size != 3 * header.nAtoms * realSize )  return false;
+        }
+
+        header.step = xdr.i32();
+        xdr.skip( 4 );                          // number of energies
+        header.time = xdr.real( header.isDouble );
+        xdr.real( header.isDouble );            // lambda
+        return xdr.good();
+    }
+
+
+
+    //
+    // header of a .xtc frame
+    // (+ the parameters of the compressed positions)
+    //
+    struct XTCHeader
+    {
+        std::size_t  nAtoms {0};
+        std::int64_t step {0};
+        float        time {0};
+        std::array<float, 9> box {};
+        float        precision {0};
+        std::array<std::int32_t, 3> minInt {};
+        std::array<std::int32_t, 3> maxInt {};
+        std::int32_t smallIndex {0};
+        std::size_t  dataOffset {0};
+        std::size_t  dataSize {0};
+    };
+
+    //
+    // read the header of a .xtc frame, returns false if there is no valid header
+    // (frames with up to 9 atoms contain uncompressed positions)
+    //
+    bool readXTCHeader(XdrReader& xdr, XTCHeader& header)
+    {
+        const auto magic = xdr.i32();
+        if( magic != xtcMagic && magic != xtcMagicLarge )   return false;
+        const auto nAtoms = xdr.i32();
+        header.step = xdr.i32();
+        header.time = xdr.f32();
+        for( auto& b: header.box )  b = xdr.f32();
+        if( nAtoms < 0 || xdr.i32() != nAtoms )    return false;
+        header.nAtoms = static_cast<std::size_t>( nAtoms );
+
+        if( header.nAtoms <= 9 )
+        {
+            header.precision = 0;
+            header.dataSize = 3 * header.nAtoms * sizeof(float);
+        }
+        else
+        {
+            header.precision = xdr.f32();
+            for( auto& i: header.minInt )   i = xdr.i32();
+            for( auto& i: header.maxInt )   i = xdr.i32();
+            header.smallIndex = xdr.i32();
+            const auto nBytes = ( magic == xtcMagicLarge ? xdr.i64() : static_cast<std::int64_t>( xdr.i32() ) );
+            if( nBytes < 0 || ! ( header.precision > 0 ) )    return false;
+            header.dataSize = static_cast<std::size_t>( nBytes );
+        }
+        header.dataOffset = xdr.getPosition();
+        return xdr.good();
+    }
+
+
+
+    //
+    // decompression of xtc positions (xdr3dfcoord, as in gromacs / xdrfile):
+    // positions are stored as integers (position * precision) relative to their minimum,
+    // either as one combined integer of three mixed-radix digits, or (for large ranges) as three separate integers,
+    // each full position can be followed by a run of small positions, which are stored relative to the
+    // previous position with a number of bits given by a magic integer (adapted from run to run)
+    //
+    constexpr std::array<std::int32_t, 73> magicInts
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        8, 10, 12, 16, 20, 25, 32, 40, 50, 64,
+        80, 101, 128, 161, 203, 256, 322, 406, 512, 645,
+        812, 1024, 1290, 1625, 2048, 2580, 3250, 4096, 5060, 6501,
+        8192, 10321, 13003, 16384, 20642, 26007, 32768, 41285, 52015, 65536,
+        82570, 104031, 131072, 165140, 208063, 262144, 330280, 416127, 524287, 660561,
+        832255, 1048576, 1321122, 1664510, 2097152, 2642245, 3329021, 4194304, 5284491, 6658042,
+        8388607, 10568983, 13316085, 16777216
+    };
+    constexpr std::int32_t firstMagicInt {9};
+
+    //
+    // number of bits needed to store an integer below the given size
+    //
+    inline int bitsOfInt(const std::uint32_t& size)
+    {
+        int bits {0};
+        std::uint64_t number {1};
+        while( size >= number && bits < 32 )
+        {
+            ++bits;
+            number <<= 1;
+        }
+        return bits;
+    }
+
+    //
+    // number of bits needed to store three integers below the given sizes as one mixed-radix number
+    //
+    inline int bitsOfInts(const std::array<std::uint32_t, 3>& sizes)
+    {
+        std::array<std::uint32_t, 32> bytes {};
+        bytes[0] = 1;
+        std::size_t nBytes {1};
+        for( const auto& size: sizes )
+        {
+            std::uint64_t carry {0};
+            std::size_t b {0};
+            for( ; b<nBytes; ++b )
+            {
+                carry = bytes[b] * std::uint64_t {size} + carry;
+                bytes[b] = carry & 0xff;
+                carry >>= 8;
+            }
+            while( carry != 0 )
+            {
+                bytes[b++] = carry & 0xff;
+                carry >>= 8;
+            }
+            nBytes = b;
+        }
+        int bits {0};
+        std::uint32_t number {1};
+        while( bytes[nBytes - 1] >= number )
+        {
+            ++bits;
+            number *= 2;
+        }
+        return bits + static_cast<int>( nBytes - 1 ) * 8;
+    }
+
+    //
+    // reader of the compressed bit stream (most significant bit first)
+    //
+    class BitReader
+    {
+        const unsigned char* data;
+        std::size_t size;
+        std::size_t count {0};
+        int           lastBits {0};
+        std::uint32_t lastByte {0};
+        bool ok {true};
+
+        inline std::uint32_t next()
+        {
+            if( count >= size )
+            {
+                ok = false;
+                return 0;
+            }
+            return data[count++];
+        }
+
+      public:
+        BitReader(const unsigned char* d, const std::size_t& n) : data(d), size(n) {}
+
+        //
+        // read an integer of the given number of bits (up to 32)
+        //
+        inline std::uint32_t bits(int nBits)
+        {
+            const std::uint32_t mask = ( nBits >= 32 ? ~std::uint32_t {0} : ( std::uint32_t {1} << nBits ) - 1 );
+            std::uint32_t number {0};
+            while( nBits >= 8 )
+            {
+                lastByte = ( lastByte << 8 ) | next();
+                number |= ( lastByte >> lastBits ) << ( nBits - 8 );
+                nBits -= 8;
+            }
+            if( nBits > 0 )
+            {
+                if( lastBits < nBits )
+                {
+                    lastBits += 8;
+                    lastByte = ( lastByte << 8 ) | next();
+                }
+                lastBits -= nBits;
+                number |= ( lastByte >> lastBits ) & ( ( std::uint32_t {1} << nBits ) - 1 );
+            }
+            return number & mask;
+        }
+
+        //
+        // read three integers stored as one mixed-radix number of the given number of bits
+        //
+        inline void ints(int nBits, const std::array<std::uint32_t, 3>& sizes, std::array<std::int64_t, 3>& numbers)
+        {
+            std::array<std::uint32_t, 32> bytes {};
+            std::size_t nBytes {0};
+            while( nBits > 8 && nBytes < bytes.size() )
+            {
+                bytes[nBytes++] = bits(8);
+                nBits -= 8;
+            }
+            if( nBits > 0 && nBytes < bytes.size() )    bytes[nBytes++] = bits(nBits);
+
+            for( std::size_t i=2; i>0; --i )
+            {
+                std::uint32_t number {0};
+                for( std::size_t j=nBytes; j-- > 0; )
+                {
+                    number = ( number << 8 ) | bytes[j];
+                    const auto quotient = number / sizes[i];
+                    bytes[j] = quotient;
+                    number -= quotient * sizes[i];
+                }
+                numbers[i] = number;
+            }
+            numbers[0] = bytes[0] | ( bytes[1] << 8 ) | ( bytes[2] << 16 ) | ( bytes[3] << 24 );
+        }
+
+        inline bool good() const { return ok; }
+    };
+
+    //
+    // decompress the positions of a .xtc frame, returns false if the data is malformed
+    //
+    bool decompressPositions(const XTCHeader& header, const unsigned char* data, std::vector<REALVEC>& positions)
+    {
+        std::array<std::uint32_t, 3> sizes {};
+        for( std::size_t d=0; d<3; ++d )
+        {
+            const auto size = std::int64_t {header.maxInt[d]} - header.minInt[d] + 1;
+            if( size <= 0 || size > std::numeric_limits<std::uint32_t>::max() )  return false;
+            sizes[d] = static_cast<std::uint32_t>( size );
+        }
+
+        // large ranges are stored as separate integers (nBits == 0)
+        int nBits {0};
+        std::array<int, 3> nBitsSeparate {};
+        if( ( sizes[0] | sizes[1] | sizes[2] ) > 0xffffff )
+        {
+            for( std::size_t d=0; d<3; ++d )    nBitsSeparate[d] = bitsOfInt( sizes[d] );
+        }
+        else
+        {
+            nBits = bitsOfInts( sizes );
+        }
+
+        auto smallIndex = header.smallIndex;
+        if( smallIndex < firstMagicInt || smallIndex >= static_cast<std::int32_t>( magicInts.size() ) )    return false;
+        std::int64_t smaller  = magicInts[ std::max(firstMagicInt, smallIndex - 1) ] / 2;
+        std::int64_t smallNum = magicInts[smallIndex] / 2;
+        std::array<std::uint32_t, 3> smallSizes {};
+        smallSizes.fill( static_cast<std::uint32_t>( magicInts[smallIndex] ) );
+
+        BitReader reader ( data, header.dataSize );
+        const float inversePrecision = 1.0f / header.precision;
+        positions.resize( header.nAtoms );
+        std::size_t nStored {0};
+        auto store = [&](const std::array<std::int64_t, 3>& coordinate)
+        {
+            positions[nStored++] = REALVEC( coordinate[0] * inversePrecision, coordinate[1] * inversePrecision, coordinate[2] * inversePrecision );
+        };
+
+        std::array<std::int64_t, 3> coordinate {};
+        std::array<std::int64_t, 3> previous {};
+        std::uint32_t run {0};      // note: kept if the next position doesn't start a new run
+        std::size_t i {0};
+        while( i < header.nAtoms )
+        {
+            // full position
+            if( nBits == 0 )
+            {
+                for( std::size_t d=0; d<3; ++d )    coordinate[d] = reader.bits( nBitsSeparate[d] );
+            }
+            else
+            {
+                reader.ints( nBits, sizes, coordinate );
+            }
+            ++i;
+            for( std::size_t d=0; d<3; ++d )    coordinate[d] += header.minInt[d];
+            previous = coordinate;
+
+            // run of small positions, and change of their size
+            int isSmaller {0};
+            if( reader.bits(1) == 1 )
+            {
+                run = reader.bits(5);
+                isSmaller = static_cast<int>( run % 3 );
+                run -= isSmaller;
+                --isSmaller;
+            }
+            if( i + run / 3 > header.nAtoms )   return false;
+
+            if( run > 0 )
+            {
+                for( std::uint32_t k=0; k<run; k+=3 )
+                {
+                    reader.ints( smallIndex, smallSizes, coordinate );
+                    ++i;
+                    for( std::size_t d=0; d<3; ++d )    coordinate[d] += previous[d] - smallNum;
+                    if( k == 0 )
+                    {
+                        // the first small position is stored before the full one (better compression of water)
+                        std::swap( coordinate, previous );
+                        store( previous );
+                    }
+                    else
+                    {
+                        previous = coordinate;
+                    }
+                    store( coordinate );
+                }
+            }
+            else
+            {
+                store( coordinate );
+            }
+
+            smallIndex += isSmaller;
+            if( smallIndex < firstMagicInt || smallIndex >= static_cast<std::int32_t>( magicInts.size() ) )    return false;
+            if( isSmaller < 0 )
+            {
+                smallNum = smaller;
+                smaller = ( smallIndex > firstMagicInt ? magicInts[smallIndex - 1] / 2 : 0 );
+            }
+            else if( isSmaller > 0 )
+            {
+                smaller = smallNum;
+                smallNum = magicInts[smallIndex] / 2;
+            }
+            smallSizes.fill( static_cast<std::uint32_t>( magicInts[smallIndex] ) );
+
+            if( ! reader.good() )   return false;
+        }
+        return reader.good() && nStored == header.nAtoms;
+    }
+}
+
+
+
+//
+// map a file and read its last frame
+//
+bool TrajectoryFile::readLastFrame(const std::string& filename, const double& minPrecision)
+{
+    positions.clear();
+    velocities.clear();
+    box.setZero();
+    step = 0;
+    time = 0;
+    precision = 0;
+
+    const auto extension = std::filesystem::path( filename ).extension();
+    if( extension != ".trr" && extension != ".xtc" )    return false;
+    if( ! file.open( filename ) )   return false;
+
+    const bool valid = ( extension == ".trr" ? readTRR( file.view() ) : readXTC( file.view(), minPrecision ) );
+    file.close();
+    if( ! valid )
+    {
+        positions.clear();
+        velocities.clear();
+    }
+    return valid;
+}
+
+
+
+//
+// read the last frame of a .trr file that contains positions
+// (frames are skipped via the sizes in their headers)
+//
+bool TrajectoryFile::readTRR(std::string_view content)
+{
+    std::size_t offset {0};
+    std::size_t lastFrame {noFrame};
+    while( offset < content.size() )
+    {
+        XdrReader xdr ( content, offset );
+        TRRHeader header {};
+        if( ! readTRRHeader(xdr, header) )  break;
+        const auto end = xdr.getPosition() + header.dataSize();
+        if( end > content.size() )  break;
+        if( header.xSize != 0 )     lastFrame = offset;
+        offset = end;
+    }
+    if( offset < content.size() )
+    {
+        rsmdDEBUG( "... ignoring incomplete data at the end of the trajectory (byte " << offset << ")" );
+    }
+    if( lastFrame == noFrame )      return false;
+
+    XdrReader xdr ( content, lastFrame );
+    TRRHeader header {};
+    readTRRHeader( xdr, header );
+    step = header.step;
+    time = header.time;
+
+    if( header.boxSize != 0 )
+    {
+        std::array<double, 9> matrix {};
+        for( auto& m: matrix )  m = xdr.real( header.isDouble );
+        box = REALVEC( static_cast<REAL>(matrix[0]), static_cast<REAL>(matrix[4]), static_cast<REAL>(matrix[8]) );
+    }
+    xdr.skip( header.virSize + header.presSize );
+
+    auto readVectors = [&](std::vector<REALVEC>& vectors)
+    {
+        vectors.resize( header.nAtoms );
+        for( auto& vector: vectors )
+        {
+            for( std::size_t d=0; d<3; ++d )    vector(d) = static_cast<REAL>( xdr.real( header.isDouble ) );
+        }
+    };
+    readVectors( positions );
+    if( header.vSize != 0 )     readVectors( velocities );
+    return xdr.good();
+}
+
+
+
+//
+// read the last frame of a .xtc file
+// (frames are skipped via the byte counts of their compressed positions)
+//
+bool TrajectoryFile::readXTC(std::string_view content, const double& minPrecision)
+{
+    std::size_t offset {0};
+    std::size_t lastFrame {noFrame};
+    while( offset < content.size() )
+    {
+        XdrReader xdr ( content, offset );
+        XTCHeader header {};
+        if( ! readXTCHeader(xdr, header) )  break;
+        if( header.dataSize > content.size() - header.dataOffset )  break;
+        const auto end = header.dataOffset + XdrReader::padded( header.dataSize );
+        if( end > content.size() )  break;
+        lastFrame = offset;
+        offset = end;
+    }
+    if( offset < content.size() )
+    {
+        rsmdDEBUG( "... ignoring incomplete data at the end of the trajectory (byte " << offset << ")" );
+    }
+    if( lastFrame == noFrame )      return false;
+
+    XdrReader xdr ( content, lastFrame );
+    XTCHeader header {};
+    readXTCHeader( xdr, header );
+    step = header.step;
+    time = header.time;
+    box = REALVEC( header.box[0], header.box[4], header.box[8] );
+    precision = header.precision;
+
+    if( header.nAtoms <= 9 )
+    {
+        positions.resize( header.nAtoms );
+        for( auto& position: positions )
+        {
+            for( std::size_t d=0; d<3; ++d )    position(d) = xdr.f32();
+        }
+        return xdr.good();
+    }
+    if( precision < minPrecision )  return false;
+    return decompressPositions( header, xdr.bytes( header.dataSize ), positions );
+}
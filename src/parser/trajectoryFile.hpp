@@ -0,0 +1,75 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "definitions.hpp"
+#include "enhance/mappedFile.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+//
+// gromacs trajectory (.trr / .xtc) file
+//
+// maps the file into memory and reads its last complete frame only:
+// - frames are skipped via their headers (which contain the size of their data),
+//   a truncated last frame (e.g. of an interrupted run) is ignored
+// - .trr: the last frame that contains positions is read (+ velocities, if the frame contains them),
+//   in the precision of the file (single or double, stored as REAL)
+// - .xtc: the compressed positions of the last frame are decompressed (xdr3dfcoord),
+//   their precision is given by the precision of the file
+// the type of the file is given by its extension
+//
+
+class TrajectoryFile
+{
+    enhance::MappedFile file {};
+    std::vector<REALVEC> positions {};
+    std::vector<REALVEC> velocities {};
+    REALVEC      box {0, 0, 0};
+    std::int64_t step {0};
+    double       time {0};
+    double       precision {0};
+
+    //
+    // read the last frame of a .trr / .xtc file (with the minimum precision for .xtc files),
+    // returns false if there is none or if it is malformed
+    //
+    bool readTRR(std::string_view);
+    bool readXTC(std::string_view, const double&);
+
+  public:
+    //
+    // map a file and read its last frame
+    // (.xtc files with a precision below the given one are not decompressed)
+    // returns false if the file doesn't exist, is not a trajectory or doesn't contain a complete frame
+    //
+    bool readLastFrame(const std::string&, const double& = 0);
+
+    //
+    // release the mapped file
+    //
+    inline void close() { file.close(); }
+
+    //
+    // some getters
+    // (precision: of the positions in 1/nm, i.e. 0 for full precision (.trr))
+    //
+    inline const auto& getPositions()  const { return positions; }
+    inline const auto& getVelocities() const { return velocities; }
+    inline const auto& getBox()        const { return box; }
+    inline const auto& getStep()       const { return step; }
+    inline const auto& getTime()       const { return time; }
+    inline const auto& getPrecision()  const { return precision; }
+};
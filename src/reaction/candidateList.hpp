@@ -0,0 +1,153 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "definitions.hpp"
+#include "container/containerBase.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <numeric>
+
+//
+// a lightweight handle for a reaction candidate
+//
+// refers to the reaction template by its index, to the reactant molecules
+// by an offset into the molecule indices stored in CandidateList,
+// and caches the value of the first (distance) criterion
+// (which is all that is needed until the candidate is actually reacted)
+//
+
+struct CandidateHandle
+{
+    std::uint32_t reaction {0};     // index of the reaction template
+    std::uint32_t offset   {0};     // offset of the reactant molecule indices in CandidateList
+    REAL          distance {0};     // value of the first distance criterion
+};
+
+
+
+//
+// candidate list container
+//
+// derived from ContainerBase
+// contains candidate handles and the (topology) indices of their reactant molecules
+//          + on request, a conflict index, i.e. the candidates per molecule (as offsets), 
+//            with which candidates that share a molecule with a reacted candidate are marked unavailable
+//            (availability is stored per offset, i.e. it does not depend on the order of the handles)
+//
+
+class CandidateList
+    : public ContainerBase<std::vector<CandidateHandle>>
+{
+    std::vector<std::uint32_t> molecules {};
+    std::vector<std::uint32_t> conflictOffsets {};      // per molecule: first entry in conflictCandidates
+    std::vector<std::uint32_t> conflictCandidates {};   // candidates (offsets) per molecule
+    std::vector<std::uint8_t>  available {};            // per offset
+
+  public:
+    //
+    // add a new candidate
+    //
+    template<typename Indices>
+    inline void addCandidate(const std::size_t& reaction, const Indices& indices, const REAL& distance)
+    {
+        data.push_back( CandidateHandle{ static_cast<std::uint32_t>(reaction), static_cast<std::uint32_t>(molecules.size()), distance } );
+        molecules.insert( molecules.end(), std::begin(indices), std::end(indices) );
+    }
+
+    //
+    // append all candidates of another list
+    //
+    inline void append(const CandidateList& other)
+    {
+        const auto shift = static_cast<std::uint32_t>(molecules.size());
+        for( auto candidate: other.data )
+        {
+            candidate.offset += shift;
+            data.push_back( candidate );
+        }
+        molecules.insert( molecules.end(), other.molecules.begin(), other.molecules.end() );
+    }
+
+    //
+    // get (topology) indices of the reactant molecules of a candidate
+    //
+    inline const std::uint32_t* getMolecules(const CandidateHandle& candidate) const
+    {
+        return molecules.data() + candidate.offset;
+    }
+
+    //
+    // build the conflict index for molecules with (topology) indices below nMolecules,
+    // given the number of reactants per reaction template (all candidates are available afterwards)
+    //
+    inline void buildConflictIndex(const std::vector<std::size_t>& nReactants, const std::size_t& nMolecules)
+    {
+        conflictOffsets.assign( nMolecules + 1, 0 );
+        for( const auto& candidate: data )
+        {
+            for( std::size_t k=0; k<nReactants[candidate.reaction]; ++k )   ++ conflictOffsets[ molecules[candidate.offset + k] + 1 ];
+        }
+        std::partial_sum( conflictOffsets.begin(), conflictOffsets.end(), conflictOffsets.begin() );
+
+        conflictCandidates.resize( conflictOffsets.back() );
+        auto next = conflictOffsets;
+        for( const auto& candidate: data )
+        {
+            for( std::size_t k=0; k<nReactants[candidate.reaction]; ++k )   conflictCandidates[ next[molecules[candidate.offset + k]] ++ ] = candidate.offset;
+        }
+        available.assign( molecules.size(), 1 );
+    }
+
+    //
+    // mark a candidate and all candidates that share a molecule with it as unavailable
+    // (in the number of conflicting candidates)
+    //
+    inline void markConflicts(const CandidateHandle& candidate, const std::size_t& nReactants)
+    {
+        for( std::size_t k=0; k<nReactants; ++k )
+        {
+            const auto m = molecules[candidate.offset + k];
+            for( auto i=conflictOffsets[m]; i<conflictOffsets[m + 1]; ++i )    available[ conflictCandidates[i] ] = 0;
+        }
+        available[ candidate.offset ] = 0;
+    }
+
+    //
+    // check whether a candidate is still available (according to the conflict index)
+    //
+    inline bool isAvailable(const CandidateHandle& candidate) const
+    {
+        return available[candidate.offset] != 0;
+    }
+
+    //
+    // check whether list contains any candidates
+    //
+    inline bool empty() const
+    {
+        return data.empty();
+    }
+
+    //
+    // clear list
+    //
+    inline void clear()
+    {
+        data.clear();
+        molecules.clear();
+        conflictOffsets.clear();
+        conflictCandidates.clear();
+        available.clear();
+    }
+};
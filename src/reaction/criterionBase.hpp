@@ -14,6 +14,7 @@
 #include "definitions.hpp"
 #include "container/containerBase.hpp"
 
+#include <memory>
 //
 // a base class for reaction criterions
 // like distances, angles etc
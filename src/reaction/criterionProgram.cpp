@@ -0,0 +1,303 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "reaction/criterionProgram.hpp"
+
+//
+// compile program from the criterions of a reaction template
+// note: atom indices in reaction templates are translated to atom indices
+// in the topology molecules via the atom ID (cf. ReactionCandidate::updateReactant)
+//
+void CriterionProgram::compile(const ReactionBase& reactionTemplate)
+{
+    data.clear();
+    const auto& reactants = reactionTemplate.getReactants();
+    for( const auto& criterion: reactionTemplate.getCriterions() )
+    {
+        CriterionOperation operation {};
+        operation.minValue = criterion->getMin();
+        operation.maxValue = criterion->getMax();
+        operation.nAtoms = static_cast<std::uint8_t>( criterion->size() );
+        for( std::size_t i=0; i<criterion->size(); ++i )
+        {
+            const auto& ixs = (*criterion)[i];
+            operation.reactants[i] = static_cast<std::uint8_t>( ixs.first );
+            operation.atoms[i] = static_cast<std::uint32_t>( reactants[ixs.first][ixs.second].id - 1 );
+            operation.stage = std::max( operation.stage, operation.reactants[i] );
+        }
+
+        if( criterion->getType() == "distance" )
+        {
+            operation.opcode = CriterionOpcode::DISTANCE;
+            operation.lower = ( operation.minValue > 0 ? static_cast<double>(operation.minValue) * operation.minValue : -1.0 );
+            operation.upper = static_cast<double>(operation.maxValue) * operation.maxValue;
+        }
+        else if( criterion->getType() == "angle" )
+        {
+            // note: cosine decreases with the angle
+            operation.opcode = CriterionOpcode::ANGLE;
+            operation.lower = ( operation.maxValue < 180 ? std::cos(enhance::deg2rad(static_cast<double>(operation.maxValue))) : -2.0 );
+            operation.upper = ( operation.minValue > 0   ? std::cos(enhance::deg2rad(static_cast<double>(operation.minValue))) :  2.0 );
+        }
+        else if( criterion->getType() == "dihedral" )
+        {
+            operation.opcode = CriterionOpcode::DIHEDRAL;
+            operation.lower = operation.minValue;
+            operation.upper = operation.maxValue;
+        }
+        else
+        {
+            rsmdCRITICAL( "unknown criterion type " << criterion->getType() << " in reaction " << reactionTemplate.getName() );
+        }
+        data.push_back( operation );
+    }
+
+    order.resize( data.size() );
+    std::iota( order.begin(), order.end(), 0 );
+    nTested.assign( data.size(), 0 );
+    nPassed.assign( data.size(), 0 );
+}
+
+
+//
+// check a single operation for the given reactant molecules
+// (the exact value is computed, if the check in check space is undecided or if it is requested)
+//
+bool CriterionProgram::check(const CriterionOperation& operation, const CoordinateStore& store, const std::size_t* offsets, const REALVEC& box, const bool& needValue, REAL& value) const
+{
+    const auto p0 = position(operation, 0, store, offsets);
+    const auto p1 = position(operation, 1, store, offsets);
+    int valid {-1};
+
+    switch( operation.opcode )
+    {
+        case CriterionOpcode::DISTANCE:
+        {
+            const float squared = enhance::distanceVector(p0, p1, box).squaredNorm();
+            valid = decide( squared, operation.lower, operation.upper, operation.lower * margin, operation.upper * margin );
+            if( valid == -1 || (valid == 1 && needValue) )  value = std::sqrt(squared);
+            break;
+        }
+        case CriterionOpcode::ANGLE:
+        {
+            const auto p2 = position(operation, 2, store, offsets);
+            const auto vector1 = enhance::distanceVector(p0, p1, box);
+            const auto vector2 = enhance::distanceVector(p1, p2, box);
+            const double cosine = static_cast<double>(vector1.dot(vector2)) / std::sqrt( static_cast<double>(vector1.squaredNorm()) * vector2.squaredNorm() );
+            valid = decide( cosine, operation.lower, operation.upper, margin, margin );
+            if( valid == -1 || (valid == 1 && needValue) )  value = enhance::angle(p0, p1, p2, box);
+            break;
+        }
+        case CriterionOpcode::DIHEDRAL:
+        {
+            value = exactValue( operation, store, offsets, box );
+            break;
+        }
+    }
+
+    // exact check, if undecided
+    if( valid == -1 )   valid = ( value >= operation.minValue && value <= operation.maxValue ) ? 1 : 0;
+    return valid == 1;
+}
+
+
+//
+// exact value of a single operation for the given reactant molecules
+// (computed in the same way as by the criterions)
+//
+REAL CriterionProgram::exactValue(const CriterionOperation& operation, const CoordinateStore& store, const std::size_t* offsets, const REALVEC& box) const
+{
+    const auto p0 = position(operation, 0, store, offsets);
+    const auto p1 = position(operation, 1, store, offsets);
+    switch( operation.opcode )
+    {
+        case CriterionOpcode::DISTANCE:
+        {
+            const float squared = enhance::distanceVector(p0, p1, box).squaredNorm();
+            return std::sqrt(squared);
+        }
+        case CriterionOpcode::ANGLE:
+        {
+            const auto p2 = position(operation, 2, store, offsets);
+            return enhance::angle(p0, p1, p2, box);
+        }
+        case CriterionOpcode::DIHEDRAL:
+        {
+            const auto p2 = position(operation, 2, store, offsets);
+            const auto p3 = position(operation, 3, store, offsets);
+            return enhance::dihedral(p0, p1, p2, p3, box);
+        }
+    }
+    return 0;
+}
+
+
+//
+// evaluate program for the given reactant molecules
+// (operations are evaluated in the current evaluation order,
+//  the evaluation stops at the first invalid criterion)
+//
+bool CriterionProgram::run(const CoordinateStore& store, const std::size_t* offsets, const REALVEC& box, REAL& firstValue) const
+{
+    for( auto c: order )
+    {
+        REAL value {0};
+        if( ! check(data[c], store, offsets, box, c == 0, value) )
+        {
+            rsmdDEBUG( "... criterion " << c << " INVALID" );
+            return false;
+        }
+        if( c == 0 )    firstValue = value;
+    }
+    rsmdDEBUG( "... all criterions are valid!" );
+    return true;
+}
+
+
+//
+// evaluate the operations of one stage for a batch of molecule combinations
+// (operations are evaluated in the current evaluation order for all combinations that are still valid:
+//  values are computed by the batched geometry kernels and checked in check space with a margin,
+//  combinations that are undecided are checked exactly)
+//
+void CriterionProgram::runBatch(const CoordinateStore& store, const std::vector<std::size_t>& offsets, const std::size_t& stage, const std::vector<std::size_t>& batchOffsets, const REALVEC& box, CriterionBatch& batch) const
+{
+    const auto n = batchOffsets.size();
+    batch.alive.resize( n );
+    std::iota( batch.alive.begin(), batch.alive.end(), 0 );
+    batch.firstValues.assign( n, 0 );
+    if( batch.nTested.size() != data.size() )
+    {
+        batch.nTested.assign( data.size(), 0 );
+        batch.nPassed.assign( data.size(), 0 );
+    }
+    batch.offsets.assign( offsets.begin(), offsets.end() );
+    batch.offsets.resize( stage + 1 );
+
+    for( auto c: order )
+    {
+        if( batch.alive.empty() )   break;
+        const auto& operation = data[c];
+        if( operation.stage != stage )  continue;
+        batch.nTested[c] += batch.alive.size();
+
+        // gather positions of the involved atoms
+        for( std::size_t a=0; a<operation.nAtoms; ++a )
+        {
+            auto& block = batch.blocks[a];
+            block.clear();
+            if( operation.reactants[a] == stage )
+            {
+                for( auto i: batch.alive )  block.push_back( store.getPosition(batchOffsets[i] + operation.atoms[a]) );
+            }
+            else
+            {
+                const auto fixed = position(operation, a, store, batch.offsets.data());
+                for( std::size_t i=0; i<batch.alive.size(); ++i )   block.push_back( fixed );
+            }
+        }
+
+        // compute values in check space and decide
+        batch.values.resize( batch.alive.size() );
+        double lower {0}, upper {0}, lowerMargin {0}, upperMargin {0};
+        switch( operation.opcode )
+        {
+            case CriterionOpcode::DISTANCE:
+                enhance::batchDistancesSquared( batch.blocks[0], batch.blocks[1], box, batch.values.data() );
+                lower = operation.lower;
+                upper = operation.upper;
+                lowerMargin = operation.lower * margin;
+                upperMargin = operation.upper * margin;
+                break;
+            case CriterionOpcode::ANGLE:
+                enhance::batchCosines( batch.blocks[0], batch.blocks[1], batch.blocks[2], box, batch.values.data() );
+                lower = operation.lower;
+                upper = operation.upper;
+                lowerMargin = upperMargin = margin;
+                break;
+            case CriterionOpcode::DIHEDRAL:
+                enhance::batchDihedrals( batch.blocks[0], batch.blocks[1], batch.blocks[2], batch.blocks[3], box, batch.values.data() );
+                lower = operation.minValue;
+                upper = operation.maxValue;
+                lowerMargin = upperMargin = dihedralMargin;
+                break;
+        }
+
+        batch.next.clear();
+        for( std::size_t j=0; j<batch.alive.size(); ++j )
+        {
+            const auto i = batch.alive[j];
+            const double value = batch.values[j];
+            int valid {-1};
+            if( value != enhance::undefinedGeometry && 
+                ( operation.opcode != CriterionOpcode::DIHEDRAL || std::abs(value) < 180 - dihedralMargin ) )
+            {
+                valid = decide( value, lower, upper, lowerMargin, upperMargin );
+            }
+            if( valid == 0 )    continue;
+
+            batch.offsets[stage] = batchOffsets[i];
+            if( valid == -1 )
+            {
+                REAL exact {0};
+                if( ! check(operation, store, batch.offsets.data(), box, c == 0, exact) )  continue;
+                if( c == 0 )    batch.firstValues[i] = exact;
+            }
+            else if( c == 0 )
+            {
+                batch.firstValues[i] = exactValue( operation, store, batch.offsets.data(), box );
+            }
+            batch.next.push_back( i );
+        }
+        batch.alive.swap( batch.next );
+        batch.nPassed[c] += batch.alive.size();
+    }
+}
+
+
+//
+// add the statistics of a batch buffer to the recorded statistics
+//
+void CriterionProgram::record(CriterionBatch& batch)
+{
+    if( batch.nTested.size() != data.size() )   return;
+    for( std::size_t c=0; c<data.size(); ++c )
+    {
+        nTested[c] += batch.nTested[c];
+        nPassed[c] += batch.nPassed[c];
+    }
+    std::fill( batch.nTested.begin(), batch.nTested.end(), 0 );
+    std::fill( batch.nPassed.begin(), batch.nPassed.end(), 0 );
+}
+
+
+//
+// update the evaluation order according to the recorded statistics:
+// operations are sorted by cost / (1 - pass rate), i.e. the expected cost 
+// per rejected combination, which minimises the expected cost of the evaluation
+// (pass rates are estimated with (passed + 1) / (tested + 2), such that operations 
+//  without statistics are ordered by cost, ties keep the order of the criterions)
+//
+bool CriterionProgram::reorder()
+{
+    std::vector<double> ranks ( data.size() );
+    for( std::size_t c=0; c<data.size(); ++c )
+    {
+        ranks[c] = cost(data[c]) / std::max( 1 - getPassRate(c), 1e-6 );
+    }
+    std::vector<std::size_t> newOrder ( data.size() );
+    std::iota( newOrder.begin(), newOrder.end(), 0 );
+    std::stable_sort( newOrder.begin(), newOrder.end(), [&](std::size_t a, std::size_t b){ return ranks[a] < ranks[b]; } );
+    
+    if( newOrder == order )     return false;
+    order.swap( newOrder );
+    return true;
+}
@@ -0,0 +1,205 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#pragma once
+
+#include "definitions.hpp"
+#include "container/containerBase.hpp"
+#include "container/coordinateStore.hpp"
+#include "reaction/reactionBase.hpp"
+#include "enhance/math_utility.hpp"
+#include "enhance/batchGeometry.hpp"
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+
+//
+// a single operation of a criterion program,
+// i.e. one criterion of a reaction template with
+// - the atoms involved, as (reactant index, atom index within the topology molecule)
+// - the thresholds of the criterion and the thresholds in the space in which
+//   the criterion is checked (squared distances, cosines of angles)
+// - the stage of the operation, i.e. the highest reactant index involved, 
+//   after which the operation can be evaluated when reactants are chosen one after another
+//
+
+enum class CriterionOpcode : std::uint8_t { DISTANCE, ANGLE, DIHEDRAL };
+
+struct CriterionOperation
+{
+    CriterionOpcode opcode {CriterionOpcode::DISTANCE};
+    std::uint8_t    nAtoms {0};
+    std::uint8_t    stage {0};
+    std::array<std::uint8_t, 4>  reactants {};
+    std::array<std::uint32_t, 4> atoms {};
+    REAL   minValue {0};
+    REAL   maxValue {0};
+    double lower {0};       // lower threshold in check space
+    double upper {0};       // upper threshold in check space
+};
+
+
+
+//
+// buffers for the batched evaluation of a criterion program
+// (one per thread, reused between calls to avoid allocations)
+// + number of tested / passed combinations per operation, to be collected by the program
+//
+
+struct CriterionBatch
+{
+    std::array<enhance::CoordinateBlock, 4> blocks {};
+    std::vector<float> values {};
+    std::vector<std::size_t> alive {};
+    std::vector<std::size_t> next {};
+    std::vector<REAL> firstValues {};
+    std::vector<std::size_t> offsets {};
+    std::vector<std::size_t> nTested {};
+    std::vector<std::size_t> nPassed {};
+};
+
+
+
+//
+// criterion program
+//
+// derived from ContainerBase
+// contains the criterions of a reaction template as a flat sequence of operations,
+// compiled once from the reaction template and evaluated for each tested combination
+// of reactant molecules without virtual calls or template molecules
+// (molecules are given as the offsets of their first atom in a coordinate store):
+// - distances are checked via squared distances
+// - angles are checked via cosines
+// - dihedrals are computed directly
+// values close to a threshold (where the cheaper check might disagree with the
+// exact value due to rounding) are decided by computing the exact value
+//
+// a program can also be evaluated stage by stage for batches of molecule combinations that only differ
+// in the last chosen reactant, the operations of the stage are then evaluated with the batched 
+// geometry kernels for all combinations that are still valid
+//
+// operations are evaluated in an adaptive order: the pass rates of the operations are
+// recorded over all searches, and cheap operations that reject many combinations are
+// moved to the front (the first criterion keeps its role, i.e. its value is returned
+// regardless of the position at which it is evaluated)
+//
+
+class CriterionProgram
+    : public ContainerBase<std::vector<CriterionOperation>>
+{
+    //
+    // relative (distances) or absolute (cosines) margin around thresholds,
+    // within which the exact value is computed
+    //
+    static constexpr double margin {1e-5};
+
+    //
+    // absolute margin (in degrees) around the thresholds of dihedrals in batched evaluations
+    //
+    static constexpr double dihedralMargin {1e-2};
+
+    //
+    // evaluation order (indices of operations) and recorded statistics per operation
+    //
+    std::vector<std::size_t>   order {};
+    std::vector<std::uint64_t> nTested {};
+    std::vector<std::uint64_t> nPassed {};
+
+    //
+    // rough relative cost of an operation
+    //
+    static inline double cost(const CriterionOperation& operation)
+    {
+        switch( operation.opcode )
+        {
+            case CriterionOpcode::DISTANCE: return 1;
+            case CriterionOpcode::ANGLE:    return 2;
+            case CriterionOpcode::DIHEDRAL: return 4;
+        }
+        return 1;
+    }
+
+    //
+    // decide for a value in check space: 1 (valid), 0 (invalid), -1 (undecided)
+    //
+    static inline int decide(const double& value, const double& lower, const double& upper, const double& lowerMargin, const double& upperMargin)
+    {
+        if( value >= lower + lowerMargin && value <= upper - upperMargin )  return 1;
+        if( value <  lower - lowerMargin || value >  upper + upperMargin )  return 0;
+        return -1;
+    }
+
+    //
+    // position of an atom of an operation, for the given reactant molecules
+    //
+    static inline REALVEC position(const CriterionOperation& operation, const std::size_t& a, const CoordinateStore& store, const std::size_t* offsets)
+    {
+        return store.getPosition( offsets[operation.reactants[a]] + operation.atoms[a] );
+    }
+
+    //
+    // check a single operation for the given reactant molecules,
+    // computes the exact value if requested (or needed for the check)
+    //
+    bool check(const CriterionOperation&, const CoordinateStore&, const std::size_t*, const REALVEC&, const bool&, REAL&) const;
+
+    //
+    // exact value of a single operation for the given reactant molecules
+    //
+    REAL exactValue(const CriterionOperation&, const CoordinateStore&, const std::size_t*, const REALVEC&) const;
+
+  public:
+    //
+    // compile program from the criterions of a reaction template
+    //
+    void compile(const ReactionBase&);
+
+    //
+    // evaluate program for the given reactant molecules (one per reactant of the template),
+    // returns the exact value of the first criterion via the last argument if all criterions are valid
+    //
+    bool run(const CoordinateStore&, const std::size_t*, const REALVEC&, REAL&) const;
+
+    //
+    // evaluate the operations of one stage for a batch of molecule combinations:
+    // the given molecules (offsets) of the earlier reactants, with each of the given molecules (offsets) as the reactant of the stage,
+    // the indices of the valid combinations (in the given order) are returned in batch.alive
+    // and, if the first criterion belongs to the stage, the exact values of the first criterion 
+    // in batch.firstValues (indexed as the given molecules)
+    //
+    void runBatch(const CoordinateStore&, const std::vector<std::size_t>&, const std::size_t&, const std::vector<std::size_t>&, const REALVEC&, CriterionBatch&) const;
+
+    //
+    // add the statistics of a batch buffer to the recorded statistics (and reset them in the buffer)
+    //
+    void record(CriterionBatch&);
+
+    //
+    // update the evaluation order according to the recorded statistics,
+    // returns true if the order changed
+    //
+    bool reorder();
+
+    //
+    // some getters
+    //
+    inline const auto& getOrder()        const { return order; }
+    inline std::size_t getStage(const std::size_t& c) const { return data[c].stage; }
+    inline const auto& getNTested()      const { return nTested; }
+    inline const auto& getNPassed()      const { return nPassed; }
+    inline double      getPassRate(const std::size_t& c) const 
+    {
+        return static_cast<double>(nPassed[c] + 1) / static_cast<double>(nTested[c] + 2);
+    }
+};
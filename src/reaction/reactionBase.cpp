@@ -49,6 +49,22 @@ const auto ReactionBase::getProduct(const std::size_t& molid) const
 }
 
 
+//
+// get reaction rate value for a given distance 
+// (of the first distance criterion)
+//
+REAL ReactionBase::getReactionRateValue(const REAL& distance) const
+{
+    REAL rateValue = reactionRate[0].second;    
+    for( const auto& pair: reactionRate )
+    {
+        if( pair.first > distance )    break;
+        rateValue = pair.second;
+    }
+    return rateValue;
+}
+
+
 Molecule& ReactionBase::getAddReactant(const std::size_t& molid) 
 {
     auto it = std::find_if( std::begin(reactants), std::end(reactants), [&molid](auto& m){ return molid == m.getID(); });
@@ -108,6 +108,7 @@ class ReactionBase
 
     inline void         setRate( const std::vector<std::pair<REAL, REAL>> r ) { reactionRate = r; }
     inline const auto&  getRate()                                       const { return reactionRate; }
+    REAL                getReactionRateValue(const REAL&)                     const;
 
     const auto          getReactant(const std::size_t&) const;
     const auto&         getReactants()      const { return reactants; }
@@ -117,6 +118,7 @@ class ReactionBase
     const auto&         getProducts()       const { return products; }
     auto&               getProducts()             { return products; }
 
+    const auto&         getCriterions()     const { return criterions; }
 
     // 
     // add stuff
@@ -29,14 +29,7 @@ REAL ReactionCandidate::getCurrentReactionRateValue() const
     // the fact that it is a "distance" criterion is never checked, 
     // but how to assure that it is the 'correct' one?
     // --> add notes for users ...
-    REAL currentDistanceValue = criterions[0]->getLatest(); 
-    REAL currentRateValue = reactionRate[0].second;    
-    for( const auto& pair: reactionRate )
-    {
-        if( pair.first > currentDistanceValue )    break;
-        currentRateValue = pair.second;
-    }
-    return currentRateValue;
+    return getReactionRateValue( criterions[0]->getLatest() );
 }
 
 
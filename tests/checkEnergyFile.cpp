@@ -0,0 +1,119 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "parser/energyFile.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cmath>
+
+//
+// fixture check of the native .edr reader:
+// averages over the end of an energy file are compared against the averages over its 'gmx energy' output (.xvg),
+// for the terms given in the legends of the .xvg file, as they were computed from .xvg files before
+// (+ the same for an energy file that ends with an incomplete frame, whose frames are found from its beginning)
+// (usage: checkEnergyFile <directory of the fixtures>)
+//
+
+namespace
+{
+    //
+    // terms (legends) and rows (time + values) of an .xvg file
+    //
+    bool readXVG(const std::string& filename, std::vector<std::string>& terms, std::vector<std::vector<double>>& rows)
+    {
+        std::ifstream FILE( filename );
+        if( ! FILE )    return false;
+        std::string line {};
+        while( std::getline(FILE, line) )
+        {
+            if( line.empty() || line[0] == '#' )    continue;
+            if( line[0] == '@' )
+            {
+                const auto pos = line.find( "legend \"" );
+                if( pos != std::string::npos )  terms.push_back( line.substr(pos + 8, line.rfind('"') - pos - 8) );
+                continue;
+            }
+            std::stringstream linestream ( line );
+            std::vector<double> row {};
+            double value {0};
+            while( linestream >> value )    row.push_back( value );
+            if( row.size() == terms.size() + 1 )    rows.push_back( row );
+        }
+        return ! terms.empty() && ! rows.empty();
+    }
+
+    bool close(const double& value, const double& reference)
+    {
+        return std::abs(value - reference) <= 1e-6 * std::max( 1.0, std::abs(reference) );
+    }
+
+    //
+    // compare the averages over the given time span at the end of an energy file with the ones of its .xvg file
+    //
+    bool check(const std::string& edr, const std::string& xvg, const double& timeSpan)
+    {
+        std::vector<std::string> terms {};
+        std::vector<std::vector<double>> rows {};
+        if( ! readXVG(xvg, terms, rows) )
+        {
+            std::cerr << "could not read " << xvg << '\n';
+            return false;
+        }
+        EnergyFile file {};
+        if( ! file.read(edr, terms, timeSpan) )
+        {
+            std::cerr << "could not read " << edr << '\n';
+            return false;
+        }
+
+        // rows from (time of the last row - time span) on, only the last one for time span 0
+        const double lastTime = rows.back()[0];
+        std::vector<double> averages ( terms.size(), 0 );
+        std::size_t counter = 0;
+        for( const auto& row: rows )
+        {
+            if( timeSpan == 0 ? &row != &rows.back() : row[0] < lastTime - timeSpan )   continue;
+            for( std::size_t t=0; t<terms.size(); ++t )     averages[t] += row[t + 1];
+            ++ counter;
+        }
+
+        bool ok = ( close(file.getTime(), lastTime) && file.getNFrames() == counter );
+        if( ! ok )  std::cerr << edr << " (time span " << timeSpan << "): time / number of frames don't match (" << file.getTime() << " / " << file.getNFrames() << " vs. " << lastTime << " / " << counter << ")\n";
+        for( std::size_t t=0; t<terms.size(); ++t )
+        {
+            averages[t] /= static_cast<double>( counter );
+            if( ! close(file.getAverages()[t], averages[t]) )
+            {
+                std::cerr << edr << " (time span " << timeSpan << "): " << terms[t] << " doesn't match (" << file.getAverages()[t] << " vs. " << averages[t] << ")\n";
+                ok = false;
+            }
+        }
+        return ok;
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    const std::string path = ( argc > 1 ? argv[1] : "." );
+    bool ok = true;
+    for( const auto& timeSpan: {0.0, 0.5, 0.9, 100.0} )
+    {
+        ok = check( path + "/energy.edr", path + "/energy.xvg", timeSpan ) && ok;
+        ok = check( path + "/energy.incomplete.edr", path + "/energy.xvg", timeSpan ) && ok;
+    }
+    std::cout << ( ok ? "energy fixtures ok" : "energy fixtures FAILED" ) << '\n';
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+/************************************************
+ *                                              *
+ *                rs@md                         *
+ *    (reactive steps @ molecular dynamics )    *
+ *                                              *
+ ************************************************/
+/*
+ Copyright 2020 Myra Biedermann
+ Licensed under the Apache License, Version 2.0
+*/
+
+#include "parser/trajectoryFile.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <array>
+#include <cmath>
+
+//
+// fixture check of the native .xtc / .trr readers:
+// the last frame of a trajectory is compared against the last frame of its 'gmx dump' output
+// (usage: checkTrajectoryFile <directory of the fixtures>)
+//
+
+namespace
+{
+    //
+    // last frame of a 'gmx dump' output
+    //
+    struct DumpFrame
+    {
+        std::size_t natoms {0};
+        long        step {0};
+        double      time {0};
+        double      precision {0};
+        std::vector<std::array<double, 3>> box {};
+        std::vector<std::array<double, 3>> x {};
+        std::vector<std::array<double, 3>> v {};
+    };
+
+    //
+    // value of a 'key=value' entry of a line
+    //
+    double readEntry(const std::string& line, const std::string& key)
+    {
+        const auto pos = line.find( key + "=" );
+        if( pos == std::string::npos )  return 0;
+        return std::stod( line.substr(pos + key.size() + 1) );
+    }
+
+    bool readDump(const std::string& filename, DumpFrame& frame)
+    {
+        std::ifstream FILE( filename );
+        if( ! FILE )    return false;
+        std::string line {};
+        std::vector<std::array<double, 3>>* rows {nullptr};
+        while( std::getline(FILE, line) )
+        {
+            if( line.find(" frame ") != std::string::npos && line.back() == ':' )
+            {
+                frame = DumpFrame {};
+                rows = nullptr;
+            }
+            else if( line.find("natoms=") != std::string::npos )
+            {
+                frame.natoms = static_cast<std::size_t>( readEntry(line, "natoms") );
+                frame.step = static_cast<long>( readEntry(line, "step") );
+                frame.time = readEntry(line, "time");
+                frame.precision = readEntry(line, "prec");
+            }
+            else if( line.find("box (") != std::string::npos )  rows = &frame.box;
+            else if( line.find("x (") != std::string::npos )    rows = &frame.x;
+            else if( line.find("v (") != std::string::npos )    rows = &frame.v;
+            else if( rows && line.find("]={") != std::string::npos )
+            {
+                std::stringstream linestream ( line.substr(line.find("]={") + 3) );
+                std::array<double, 3> row {};
+                char separator {};
+                linestream >> row[0] >> separator >> row[1] >> separator >> row[2];
+                rows->push_back( row );
+            }
+        }
+        return frame.natoms != 0;
+    }
+
+    bool close(const double& value, const double& reference)
+    {
+        return std::abs(value - reference) <= 1e-5 * std::max( 1.0, std::abs(reference) );
+    }
+
+    //
+    // compare the last frame of a trajectory with the last frame of its dump
+    //
+    bool check(const std::string& trajectory, const std::string& dump)
+    {
+        DumpFrame reference {};
+        if( ! readDump(dump, reference) )
+        {
+            std::cerr << "could not read " << dump << '\n';
+            return false;
+        }
+        TrajectoryFile file {};
+        if( ! file.readLastFrame(trajectory) )
+        {
+            std::cerr << "could not read the last frame of " << trajectory << '\n';
+            return false;
+        }
+
+        bool ok = true;
+        auto expect = [&](const bool& condition, const std::string& what)
+        {
+            if( ! condition )   std::cerr << trajectory << ": " << what << " doesn't match\n";
+            ok = ok && condition;
+        };
+        expect( file.getStep() == reference.step, "step" );
+        expect( close(file.getTime(), reference.time), "time" );
+        expect( close(file.getPrecision(), reference.precision), "precision" );
+        for( std::size_t d=0; d<3 && d<reference.box.size(); ++d )
+        {
+            expect( close(file.getBox()(d), reference.box[d][d]), "box" );
+        }
+        expect( file.getPositions().size() == reference.natoms && reference.x.size() == reference.natoms, "number of atoms" );
+        expect( file.getVelocities().size() == reference.v.size(), "number of velocities" );
+        if( ! ok )  return false;
+
+        for( std::size_t i=0; i<reference.natoms; ++i )
+        {
+            for( std::size_t d=0; d<3; ++d )
+            {
+                expect( close(file.getPositions()[i](d), reference.x[i][d]), "position of atom " + std::to_string(i) );
+                if( ! reference.v.empty() )     expect( close(file.getVelocities()[i](d), reference.v[i][d]), "velocity of atom " + std::to_string(i) );
+            }
+        }
+        file.close();
+        return ok;
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    const std::string path = ( argc > 1 ? argv[1] : "." );
+    bool ok = check( path + "/frame.xtc", path + "/frame.xtc.dump" );
+    ok = check( path + "/frame.trr", path + "/frame.trr.dump" ) && ok;
+    std::cout << ( ok ? "trajectory fixtures ok" : "trajectory fixtures FAILED" ) << '\n';
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,284 @@
+#!/usr/bin/python3
+
+
+# python script to create the fixtures of the checks of the native gromacs file readers
+#
+# writes, from known values:
+# - frame.xtc / frame.trr: two frames each (25 atoms, the xtc frames with runs of small (water-like) differences)
+# - energy.edr:            single precision, frames with and without sums, with subblocks, and a frame without energies
+#                          (+ energy.incomplete.edr: the same frames followed by an incomplete one)
+# + the references in the layouts of 'gmx dump -f frame.xtc' / 'gmx dump -f frame.trr' / 'gmx energy -f energy.edr'
+#   (select Potential + Coul-SR:xxx-rest), i.e. the references can be replaced by the output of gromacs,
+#   the encoding below follows the gromacs file formats (xdrfile / enxio), independently of the readers of rs@md
+#
+
+
+import struct
+import os
+
+
+
+## xdr helpers
+def xdr_int(v):     return struct.pack('>i', v)
+def xdr_uint(v):    return struct.pack('>I', v)
+def xdr_int64(v):   return struct.pack('>q', v)
+def xdr_float(v):   return struct.pack('>f', v)
+def xdr_double(v):  return struct.pack('>d', v)
+def xdr_opaque(b):  return b + b'\0' * ((-len(b)) % 4)
+def xdr_string(s):
+    b = s.encode()
+    return xdr_uint(len(b)) + xdr_opaque(b)
+def as_float(v):    return struct.unpack('>f', xdr_float(v))[0]
+
+
+
+## xdr3dfcoord compression
+MAGICINTS = [0, 0, 0, 0, 0, 0, 0, 0, 0, 8, 10, 12, 16, 20, 25, 32, 40, 50, 64,
+             80, 101, 128, 161, 203, 256, 322, 406, 512, 645, 812, 1024, 1290,
+             1625, 2048, 2580, 3250, 4096, 5060, 6501, 8192, 10321, 13003,
+             16384, 20642, 26007, 32768, 41285, 52015, 65536, 82570, 104031,
+             131072, 165140, 208063, 262144, 330280, 416127, 524287, 660561,
+             832255, 1048576, 1321122, 1664510, 2097152, 2642245, 3329021,
+             4194304, 5284491, 6658042, 8388607, 10568983, 13316085, 16777216]
+FIRSTIDX = 9
+
+class BitWriter:
+    def __init__(self):
+        self.bits = []
+    def put(self, value, nbits):
+        for i in reversed(range(nbits)):
+            self.bits.append((value >> i) & 1)
+    def bytes(self):
+        out = bytearray((len(self.bits) + 7) // 8)
+        for i, bit in enumerate(self.bits):
+            if bit:
+                out[i // 8] |= 0x80 >> (i % 8)
+        return bytes(out)
+
+def sizeofint(size):
+    nbits, num = 0, 1
+    while size >= num and nbits < 32:
+        nbits += 1
+        num <<= 1
+    return nbits
+
+def sizeofints(sizes):
+    product = 1
+    for s in sizes:
+        product *= s
+    return product.bit_length()
+
+def sendints(writer, nbits, sizes, nums):
+    # mixed radix number, written as little-endian bytes (the last byte only with its remaining bits)
+    value = (nums[0] * sizes[1] + nums[1]) * sizes[2] + nums[2]
+    nbytes = max(1, (value.bit_length() + 7) // 8)
+    data = value.to_bytes(nbytes, 'little')
+    if nbits >= nbytes * 8:
+        for b in data:
+            writer.put(b, 8)
+        writer.put(0, nbits - nbytes * 8)
+    else:
+        for b in data[:-1]:
+            writer.put(b, 8)
+        writer.put(data[-1], nbits - (nbytes - 1) * 8)
+
+def compress(ints, smallidx, changes):
+    # ints: integer coordinates, changes: sequence of changes of smallidx (-1, 0, 1) per written (full) atom
+    mins = [min(p[d] for p in ints) for d in range(3)]
+    maxs = [max(p[d] for p in ints) for d in range(3)]
+    sizeint = [maxs[d] - mins[d] + 1 for d in range(3)]
+    bitsize = sizeofints(sizeint)
+    header = b''.join(xdr_int(v) for v in mins + maxs) + xdr_int(smallidx)
+
+    writer = BitWriter()
+    i, prevrun, step = 0, -1, 0
+    n = len(ints)
+    while i < n:
+        smallnum = MAGICINTS[smallidx] // 2
+        small = [MAGICINTS[smallidx]] * 3
+        fits = lambda a, b: all(0 <= a[d] - b[d] + smallnum < MAGICINTS[smallidx] for d in range(3))
+
+        # a run: the first two atoms are swapped (as for water), i.e. the second atom is written in full
+        run, full = [], i
+        if i + 1 < n and fits(ints[i], ints[i + 1]):
+            full, run, prev, j = i + 1, [i], i, i + 2
+            while j < n and len(run) < 8 and fits(ints[j], ints[prev]):
+                run.append(j)
+                prev, j = j, j + 1
+
+        sendints(writer, bitsize, sizeint, [ints[full][d] - mins[d] for d in range(3)])
+        change = changes[step % len(changes)]
+        if not ( FIRSTIDX <= smallidx + change < len(MAGICINTS) ):
+            change = 0
+        runlength = 3 * len(run)
+        if runlength == prevrun and change == 0:
+            writer.put(0, 1)
+        else:
+            writer.put(1, 1)
+            writer.put(runlength + change + 1, 5)
+            prevrun = runlength
+        prev = ints[full]
+        for k in run:
+            sendints(writer, smallidx, small, [ints[k][d] - prev[d] + smallnum for d in range(3)])
+            prev = ints[k]
+        i = max(run[-1], full) + 1 if run else i + 1
+        smallidx += change
+        step += 1
+
+    data = writer.bytes()
+    return header + xdr_int(len(data)) + xdr_opaque(data)
+
+def xtc_frame(step, time, box, positions, precision, smallidx, changes):
+    n = len(positions)
+    out = xdr_int(1995) + xdr_int(n) + xdr_int(step) + xdr_float(time)
+    out += b''.join(xdr_float(box[r][c]) for r in range(3) for c in range(3))
+    out += xdr_int(n) + xdr_float(precision)
+    ints = [[int(round(x * precision)) for x in p] for p in positions]
+    return out + compress(ints, smallidx, changes)
+
+def trr_frame(step, time, box, positions, velocities):
+    n = len(positions)
+    out = xdr_int(1993) + xdr_int(13) + xdr_int(12) + xdr_opaque(b'GMX_trn_file')
+    sizes = [0, 0, 9 * 4, 0, 0, 0, 0, 3 * n * 4 if positions else 0, 3 * n * 4 if velocities else 0, 0]
+    out += b''.join(xdr_int(s) for s in sizes) + xdr_int(n) + xdr_int(step) + xdr_int(0)
+    out += xdr_float(time) + xdr_float(0.0)
+    out += b''.join(xdr_float(box[r][c]) for r in range(3) for c in range(3))
+    for block in (positions, velocities):
+        if block:
+            out += b''.join(xdr_float(x) for p in block for x in p)
+    return out
+
+
+
+## configurations: 8 water-like molecules, i.e. atoms in triples close to each other (+ an ion)
+def configuration(frame):
+    positions = []
+    for m in range(8):
+        o = [0.311 + 0.347 * m + 0.013 * frame, 1.207 - 0.121 * m, 0.503 + 0.219 * (m % 3) + 0.007 * frame]
+        positions.append(o)
+        positions.append([o[0] + 0.041, o[1] + 0.029, o[2] - 0.012])
+        positions.append([o[0] - 0.039, o[1] + 0.031, o[2] + 0.017])
+        if m == 3:
+            positions.append([2.513 - 0.011 * frame, 0.097, 2.851])    # an ion, i.e. an atom without a run
+    return positions
+
+def velocities(frame):
+    return [[0.1 * ((i * 7 + d * 3 + frame) % 11 - 5) for d in range(3)] for i in range(25)]
+
+BOX = [[2.9, 0, 0], [0, 3.1, 0], [0, 0, 3.3]]
+
+def dump_header(name, frame, natoms, step, time, extra=''):
+    return (f'{name} frame {frame}:\n'
+            f'   natoms={natoms:10d}  step={step:10d}  time={time:.7e}{extra}\n')
+
+def dump_matrix(name, rows):
+    out = f'   {name} ({len(rows)}x3):\n'
+    for i, r in enumerate(rows):
+        out += f'      {name}[{i:5d}]={{{r[0]:12.5e}, {r[1]:12.5e}, {r[2]:12.5e}}}\n'
+    return out
+
+def write_trajectories(path):
+    precision = 1000.0
+    xtc, xtcDump = b'', ''
+    trr, trrDump = b'', ''
+    for frame, (step, time) in enumerate([(0, 0.0), (500, 1.0)]):
+        positions = configuration(frame)
+        xtc += xtc_frame(step, time, BOX, positions, precision, 20 + frame, [0, 1, 0, -1, 0, 0, 1])
+        decoded = [[round(x * precision) / precision for x in p] for p in positions]
+        xtcDump += dump_header('frame.xtc', frame, len(positions), step, time, f'  prec={precision:10g}')
+        xtcDump += '   box (3x3):\n' + ''.join(f'      box[{r:5d}]={{{BOX[r][0]:12.5e}, {BOX[r][1]:12.5e}, {BOX[r][2]:12.5e}}}\n' for r in range(3))
+        xtcDump += dump_matrix('x', [[as_float(x) for x in p] for p in decoded])
+
+        trr += trr_frame(step, time, BOX, positions, velocities(frame) if frame else None)
+        trrDump += dump_header('frame.trr', frame, len(positions), step, time, '  lambda=0.0000000e+00')
+        trrDump += '   box (3x3):\n' + ''.join(f'      box[{r:5d}]={{{BOX[r][0]:12.5e}, {BOX[r][1]:12.5e}, {BOX[r][2]:12.5e}}}\n' for r in range(3))
+        trrDump += dump_matrix('x', [[as_float(x) for x in p] for p in positions])
+        if frame:
+            trrDump += dump_matrix('v', [[as_float(x) for x in p] for p in velocities(frame)])
+
+    open(os.path.join(path, 'frame.xtc'), 'wb').write(xtc)
+    open(os.path.join(path, 'frame.xtc.dump'), 'w').write(xtcDump)
+    open(os.path.join(path, 'frame.trr'), 'wb').write(trr)
+    open(os.path.join(path, 'frame.trr.dump'), 'w').write(trrDump)
+
+
+
+## energies: header with names (+ units), frames (single precision, version 5) with energies (+ sums), blocks of subblocks
+ENERGY_NAMES = ['Bond', 'Angle', 'LJ (SR)', 'Coulomb (SR)', 'Potential', 'Kinetic En.', 'Total Energy',
+                'Temperature', 'Pressure', 'Coul-SR:xxx-rest', 'LJ-SR:xxx-rest']
+ENERGY_TERMS = ['Potential', 'Coul-SR:xxx-rest']
+
+def energy_value(name, frame):
+    index = ENERGY_NAMES.index(name)
+    return as_float(-1000.0 * (index + 1) + 13.37 * frame - 0.251 * frame * frame + 0.5 * index)
+
+def subblocks():
+    # (type, data) with types 0: int, 1: float, 2: double, 3: int64, 4: char (as int), 5: string (int + string)
+    return [(0, b''.join(xdr_int(v) for v in [1, -2, 3])),
+            (1, b''.join(xdr_float(v) for v in [0.5, -0.25])),
+            (2, xdr_double(1.0e-3)),
+            (3, xdr_int64(-7777777)),
+            (4, b''.join(xdr_int(ord(c)) for c in 'abcde')),
+            (5, b''.join(xdr_int(0) + xdr_string(t) for t in ['dhdl', '-2e10']))]
+
+def subblock_count(kind, data):
+    if kind == 5:   return 2
+    return len(data) // ({0: 4, 1: 4, 2: 8, 3: 8, 4: 4}[kind])
+
+def energy_frame(step, time, nsum, energies, blocks):
+    out = xdr_float(-2e10) + xdr_int(-7777777) + xdr_int(5)
+    out += xdr_double(time) + xdr_int64(step) + xdr_int(nsum) + xdr_int64(max(nsum, 1)) + xdr_double(0.002)
+    out += xdr_int(len(energies)) + xdr_int(0) + xdr_int(len(blocks))
+    for block in blocks:
+        out += xdr_int(block[0]) + xdr_int(len(block[1]))
+        for kind, data in block[1]:
+            out += xdr_int(kind) + xdr_int(subblock_count(kind, data))
+    out += xdr_int(0) + xdr_int(0) + xdr_int(0)
+    for e in energies:
+        out += xdr_float(e)
+        if nsum > 0:
+            out += xdr_float(e + 0.125) + xdr_float(e * nsum)
+    for block in blocks:
+        for kind, data in block[1]:
+            out += data
+    return out
+
+def write_energies(path):
+    edr = xdr_int(-55555) + xdr_int(5) + xdr_int(len(ENERGY_NAMES))
+    for name in ENERGY_NAMES:
+        edr += xdr_string(name) + xdr_string('kJ/mol')
+
+    xvg  = '# This file was created by makeFixtures.py (in the layout of gmx energy)\n'
+    xvg += '@    title "GROMACS Energies"\n'
+    xvg += '@    xaxis  label "Time (ps)"\n'
+    xvg += '@    yaxis  label "(kJ/mol)"\n'
+    xvg += '@TYPE xy\n'
+    xvg += '@ view 0.15, 0.15, 0.75, 0.85\n'
+    xvg += '@ legend on\n'
+    for i, term in enumerate(ENERGY_TERMS):
+        xvg += f'@ s{i} legend "{term}"\n'
+
+    for frame in range(10):
+        step, time = 100 * frame, 0.2 * frame
+        blocks = [(1, subblocks())] if frame % 3 == 1 else []
+        if frame == 6:
+            # a frame without energies, skipped by gmx energy
+            edr += energy_frame(step, time, 0, [], [(2, subblocks()[:2])])
+            continue
+        nsum = 0 if frame in (0, 4) else 100
+        energies = [energy_value(name, frame) for name in ENERGY_NAMES]
+        edr += energy_frame(step, time, nsum, energies, blocks)
+        xvg += f'{time:12.6f}' + ''.join(f'  {energy_value(term, frame):12.6f}' for term in ENERGY_TERMS) + '\n'
+
+    open(os.path.join(path, 'energy.edr'), 'wb').write(edr)
+    # + the same energies followed by an incomplete frame (e.g. of an interrupted run)
+    incomplete = energy_frame(1000, 2.0, 100, [energy_value(name, 10) for name in ENERGY_NAMES], [(1, subblocks())])
+    open(os.path.join(path, 'energy.incomplete.edr'), 'wb').write(edr + incomplete[:len(incomplete) // 2])
+    open(os.path.join(path, 'energy.xvg'), 'w').write(xvg)
+
+
+
+if __name__ == '__main__':
+    path = os.path.dirname(os.path.abspath(__file__))
+    write_trajectories(path)
+    write_energies(path)